@@ -0,0 +1,47 @@
+#ifndef BIGINT_ALLOC_COUNTER_H
+#define BIGINT_ALLOC_COUNTER_H
+
+// Replaces the global allocation functions to count heap allocations.
+// Include from exactly one translation unit of a benchmark executable.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<size_t> heap_allocations(0);
+}
+
+inline size_t allocation_count() {
+	return heap_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	std::free(p);
+}
+#endif //BIGINT_ALLOC_COUNTER_H
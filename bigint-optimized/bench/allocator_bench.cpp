@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+
+// Time of one simulated request, which builds a batch of numbers, folds
+// them into a product and prints it, with limbs taken from the default
+// heap, from a monotonic buffer released after every request and from a
+// pool resource kept across requests.
+
+namespace {
+size_t const requests = 2000;
+
+void request(std::vector<int> const& factors) {
+	std::vector<big_integer> values;
+	values.reserve(factors.size());
+	for (int f : factors) {
+		values.push_back(big_integer(f) << 160);
+	}
+	big_integer product = 1;
+	for (big_integer const& v : values) {
+		product *= v;
+		product %= values.front() * values.back() + 1;
+	}
+	std::string s = to_string(product);
+	do_not_optimize(s);
+}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::vector<int> factors(64);
+	for (int& f : factors) {
+		f = static_cast<int>(rng() >> 1u);
+	}
+
+	double heap = measure_ns(requests, [&] {
+		request(factors);
+	});
+
+	std::pmr::monotonic_buffer_resource monotonic(1 << 16);
+	double buffer = measure_ns(requests, [&] {
+		{
+			scoped_limb_resource scope(&monotonic);
+			request(factors);
+		}
+		monotonic.release();
+	});
+
+	std::pmr::unsynchronized_pool_resource pool;
+	double pooled = measure_ns(requests, [&] {
+		scoped_limb_resource scope(&pool);
+		request(factors);
+	});
+
+	std::printf("%-24s %14s\n", "resource", "ns/request");
+	std::printf("%-24s %14.1f\n", "default heap", heap);
+	std::printf("%-24s %14.1f\n", "monotonic_buffer", buffer);
+	std::printf("%-24s %14.1f\n", "unsynchronized_pool", pooled);
+	return 0;
+}
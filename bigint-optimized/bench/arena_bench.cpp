@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "alloc_counter.h"
+#include "bench_util.h"
+
+// Heap allocations and time per operation once the scratch arena is warm.
+// In-place arithmetic on a uniquely owned value must not allocate at all;
+// to_string still allocates the std::string it returns.
+
+namespace {
+struct result {
+	double ns;
+	double allocations;
+};
+
+template<typename F>
+result run(size_t iterations, F&& f) {
+	for (size_t i = 0; i < iterations / 4 + 16; i++) {
+		f();
+	}
+	size_t before = allocation_count();
+	double ns = measure_ns(iterations, f);
+	return {ns, static_cast<double>(allocation_count() - before) / iterations};
+}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	bool steady = true;
+	std::printf("%-10s %8s %14s %12s\n", "op", "limbs", "ns/op", "allocs/op");
+	for (size_t limbs : {4, 16, 64, 256, 1024}) {
+		size_t iterations = 4000000 / (limbs * limbs) + 10;
+		big_integer m = random_big_integer(limbs, rng);
+		big_integer y = random_big_integer(limbs - 1, rng);
+		big_integer x = random_big_integer(limbs - 1, rng);
+
+		result modmul = run(iterations, [&] {
+			x *= y;
+			x %= m;
+			do_not_optimize(x);
+		});
+		result divmul = run(iterations, [&] {
+			x *= m;
+			x /= m;
+			do_not_optimize(x);
+		});
+		result str = run(iterations, [&] {
+			std::string s = to_string(x);
+			do_not_optimize(s);
+		});
+
+		std::printf("%-10s %8zu %14.1f %12.3f\n", "modmul", limbs, modmul.ns, modmul.allocations);
+		std::printf("%-10s %8zu %14.1f %12.3f\n", "mul+div", limbs, divmul.ns, divmul.allocations);
+		std::printf("%-10s %8zu %14.1f %12.3f\n", "to_string", limbs, str.ns, str.allocations);
+		steady = steady && modmul.allocations == 0 && divmul.allocations == 0;
+	}
+	if (!steady) {
+		std::printf("in-place arithmetic allocated in steady state\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "limb_batch.h"
+
+// Column-wise addition, multiplication and comparison of small numbers:
+// a loop of big_integer operators next to the struct-of-arrays batch
+// kernels over the same values.
+
+namespace {
+size_t const COUNT = 1 << 16;
+size_t const ITERATIONS = 20;
+
+void run(size_t limbs, std::mt19937& rng) {
+	std::vector<big_integer> a, b;
+	limb_batch sa(limbs, COUNT), sb(limbs, COUNT);
+	for (size_t j = 0; j < COUNT; j++) {
+		a.push_back(random_big_integer(limbs, rng));
+		b.push_back(random_big_integer(limbs, rng));
+		sa.set(j, a[j]);
+		sb.set(j, b[j]);
+	}
+
+	std::vector<big_integer> sums = a;
+	double scalar_add = measure_ns(ITERATIONS, [&] {
+		for (size_t j = 0; j < COUNT; j++) {
+			sums[j] += b[j];
+		}
+	}) / COUNT;
+	limb_batch batch_sums(limbs, COUNT);
+	std::vector<uint32_t> carry(COUNT);
+	double batch_add = measure_ns(ITERATIONS, [&] {
+		add_n_batch(batch_sums.data(), sa.data(), sb.data(), limbs, COUNT, carry.data());
+	}) / COUNT;
+
+	std::vector<big_integer> products(COUNT);
+	double scalar_mul = measure_ns(ITERATIONS, [&] {
+		for (size_t j = 0; j < COUNT; j++) {
+			products[j] = a[j] * b[j];
+		}
+	}) / COUNT;
+	limb_batch batch_products(2 * limbs, COUNT);
+	double batch_mul = measure_ns(ITERATIONS, [&] {
+		mul_batch(batch_products.data(), sa.data(), limbs, sb.data(), limbs, COUNT);
+	}) / COUNT;
+
+	size_t less = 0;
+	double scalar_cmp = measure_ns(ITERATIONS, [&] {
+		for (size_t j = 0; j < COUNT; j++) {
+			less += a[j] < b[j];
+		}
+	}) / COUNT;
+	std::vector<int> order(COUNT);
+	double batch_cmp = measure_ns(ITERATIONS, [&] {
+		cmp_batch(order.data(), sa.data(), sb.data(), limbs, COUNT);
+	}) / COUNT;
+	do_not_optimize(less);
+
+	for (size_t j = 0; j < COUNT; j += COUNT / 8) {
+		if (batch_products.get(j) != products[j] || (order[j] < 0) != (a[j] < b[j])) {
+			std::printf("mismatch at %zu\n", j);
+		}
+	}
+	std::printf("%8zu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", limbs,
+	            scalar_add, batch_add, scalar_mul, batch_mul, scalar_cmp, batch_cmp);
+}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::printf("ns per number\n");
+	std::printf("%8s %10s %10s %10s %10s %10s %10s\n", "limbs", "add", "add_n_b", "mul", "mul_b", "cmp", "cmp_b");
+	for (size_t limbs : {2, 4, 8, 16}) {
+		run(limbs, rng);
+	}
+	return 0;
+}
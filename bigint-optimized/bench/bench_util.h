@@ -0,0 +1,37 @@
+#ifndef BIGINT_BENCH_UTIL_H
+#define BIGINT_BENCH_UTIL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+
+#include "big_integer.h"
+
+template<typename T>
+inline void do_not_optimize(T const& value) {
+	asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Runs f the given number of times and returns the mean time of one run.
+template<typename F>
+double measure_ns(size_t iterations, F&& f) {
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		f();
+	}
+	auto finish = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(finish - start).count() / iterations;
+}
+
+// Positive number of exactly the given count of limbs, each holding 31
+// random bits.
+inline big_integer random_big_integer(size_t limbs, std::mt19937& rng) {
+	big_integer result;
+	for (size_t i = 0; i < limbs; i++) {
+		result <<= 32;
+		result += static_cast<int>((rng() >> 1u) | (i == 0));
+	}
+	return result;
+}
+#endif //BIGINT_BENCH_UTIL_H
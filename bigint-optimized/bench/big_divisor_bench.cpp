@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "big_divisor.h"
+
+// Dividing many dividends by one multi-limb divisor: operator/ and
+// operator%, which normalize the divisor on every call, next to divide()
+// and mod() with a big_divisor prepared once.
+
+namespace {
+size_t const DIVIDENDS = 256;
+size_t const TOTAL_LIMBS = 1 << 18;
+
+big_integer random_value(size_t limbs, std::mt19937& rng) {
+	static char const digits[] = "0123456789ABCDEF";
+	std::string hex(8 * limbs, '0');
+	for (char& c : hex) {
+		c = digits[rng() % 16];
+	}
+	hex[0] = '9';
+	return from_string(hex, 16);
+}
+
+void run(size_t an, size_t bn, std::mt19937& rng) {
+	std::vector<big_integer> dividends;
+	for (size_t i = 0; i < DIVIDENDS; i++) {
+		dividends.push_back(random_value(an, rng));
+	}
+	big_integer const divisor = random_value(bn, rng);
+	big_divisor const prepared(divisor);
+	size_t iterations = TOTAL_LIMBS / (an * DIVIDENDS) + 1;
+	big_integer sum1, sum2;
+	double plain = measure_ns(iterations, [&] {
+		for (big_integer const& a : dividends) {
+			sum1 += a / divisor + a % divisor;
+		}
+	}) / DIVIDENDS;
+	double cached = measure_ns(iterations, [&] {
+		for (big_integer const& a : dividends) {
+			sum2 += divide(a, prepared) + mod(a, prepared);
+		}
+	}) / DIVIDENDS;
+	if (sum1 != sum2) {
+		std::printf("mismatch at %zu / %zu limbs\n", an, bn);
+	}
+	std::printf("%8zu %8zu %14.1f %14.1f\n", an, bn, plain, cached);
+}
+}
+
+int main() {
+	std::mt19937 rng(2024);
+	std::printf("%8s %8s %14s %14s\n", "dividend", "divisor", "operator ns", "big_divisor ns");
+	run(4, 3, rng);
+	run(8, 4, rng);
+	run(16, 8, rng);
+	run(64, 32, rng);
+	run(256, 16, rng);
+	return 0;
+}
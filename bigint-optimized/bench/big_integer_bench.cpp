@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "big_integer_gmp.h"
+
+// Every operator of big_integer next to big_integer_gmp on the same values,
+// over operand sizes of 1 to 2^20 limbs in steps of four. Prints JSON in the
+// layout of Google Benchmark, with the GMP time and the ratio as extra
+// fields of each run, so the output of the bigint/ and bigint-optimized/
+// builds can be diffed or fed to a tracker. Only uses the interface both
+// implementations share, it is built in both directories.
+//
+// Options: --min_time=<seconds per run, 0.1>, --max_time=<seconds for one
+// call, 10>, --max_limbs=<2^20>, --filter=<substring of the run name>.
+// The next size is four times longer, so once one call of an
+// implementation takes over max_time / 16 its larger sizes of that
+// operation are reported as skipped rather than risk a quadratic blowup.
+
+namespace {
+enum class op {
+	add, sub, mul, div, mod, bit_and, bit_or, bit_xor, shl, shr, to_string, parse
+};
+
+char const* const OP_NAMES[] = {
+	"add", "sub", "mul", "div", "mod", "and", "or", "xor", "shl", "shr", "to_string", "parse"
+};
+
+size_t const OPS = sizeof(OP_NAMES) / sizeof(OP_NAMES[0]);
+int const SHIFT = 12345;
+
+struct options {
+	double min_time = 0.1;
+	double max_time = 10;
+	size_t max_limbs = size_t(1) << 20u;
+	std::string filter;
+};
+
+// Built by halves so that it takes O(n log n) with linear shifts and
+// additions, which both implementations have.
+template<typename T>
+T build(std::vector<uint32_t> const& limbs, size_t first, size_t last) {
+	if (last - first == 1) {
+		T high = static_cast<int>(limbs[first] >> 16u);
+		return (high << 16) + T(static_cast<int>(limbs[first] & 0xFFFFu));
+	}
+	size_t middle = first + (last - first) / 2;
+	return (build<T>(limbs, middle, last) << static_cast<int>(32 * (middle - first))) + build<T>(limbs, first, middle);
+}
+
+template<typename T>
+struct operands {
+	T a;
+	T b;
+	T wide;
+	std::string decimal;
+};
+
+template<typename T>
+operands<T> make_operands(std::vector<uint32_t> const& a, std::vector<uint32_t> const& b,
+                          std::vector<uint32_t> const& wide) {
+	operands<T> result;
+	result.a = build<T>(a, 0, a.size());
+	result.b = build<T>(b, 0, b.size());
+	result.wide = -build<T>(wide, 0, wide.size());
+	return result;
+}
+
+// Runs the operation once; the result goes to out for checking.
+template<typename T>
+void run_once(op o, operands<T> const& x, std::string& out) {
+	switch (o) {
+	case op::add: { T r = x.a + x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::sub: { T r = x.b - x.a; do_not_optimize(r); out = to_string(r); break; }
+	case op::mul: { T r = x.a * x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::div: { T r = x.wide / x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::mod: { T r = x.wide % x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::bit_and: { T r = x.wide & x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::bit_or: { T r = x.wide | x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::bit_xor: { T r = x.wide ^ x.b; do_not_optimize(r); out = to_string(r); break; }
+	case op::shl: { T r = x.wide << SHIFT; do_not_optimize(r); out = to_string(r); break; }
+	case op::shr: { T r = x.wide >> SHIFT; do_not_optimize(r); out = to_string(r); break; }
+	case op::to_string: { out = to_string(x.a); do_not_optimize(out); break; }
+	case op::parse: { T r(x.decimal); do_not_optimize(r); out = to_string(r); break; }
+	}
+}
+
+// The timed loop leaves out the conversion run_once uses for checking.
+template<typename T>
+void run_timed(op o, operands<T> const& x) {
+	switch (o) {
+	case op::add: { T r = x.a + x.b; do_not_optimize(r); break; }
+	case op::sub: { T r = x.b - x.a; do_not_optimize(r); break; }
+	case op::mul: { T r = x.a * x.b; do_not_optimize(r); break; }
+	case op::div: { T r = x.wide / x.b; do_not_optimize(r); break; }
+	case op::mod: { T r = x.wide % x.b; do_not_optimize(r); break; }
+	case op::bit_and: { T r = x.wide & x.b; do_not_optimize(r); break; }
+	case op::bit_or: { T r = x.wide | x.b; do_not_optimize(r); break; }
+	case op::bit_xor: { T r = x.wide ^ x.b; do_not_optimize(r); break; }
+	case op::shl: { T r = x.wide << SHIFT; do_not_optimize(r); break; }
+	case op::shr: { T r = x.wide >> SHIFT; do_not_optimize(r); break; }
+	case op::to_string: { std::string r = to_string(x.a); do_not_optimize(r); break; }
+	case op::parse: { T r(x.decimal); do_not_optimize(r); break; }
+	}
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct timing {
+	bool skipped;
+	size_t iterations;
+	double ns;
+};
+
+// One call decides the iteration count for min_time and whether the next
+// size is worth running.
+template<typename T>
+timing measure(op o, operands<T> const& x, options const& opts, bool& too_slow) {
+	timing result = {true, 0, 0};
+	if (too_slow) {
+		return result;
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	run_timed(o, x);
+	double once = seconds_since(start);
+	if (once > opts.max_time / 16) {
+		too_slow = true;
+	}
+	size_t iterations = std::max<size_t>(1, static_cast<size_t>(opts.min_time / std::max(once, 1e-9)));
+	iterations = std::min<size_t>(iterations, 1000000);
+	result.skipped = false;
+	result.iterations = iterations;
+	result.ns = measure_ns(iterations, [&] { run_timed(o, x); });
+	return result;
+}
+
+std::vector<uint32_t> random_limbs(size_t n, std::mt19937& rng) {
+	std::vector<uint32_t> result(n);
+	for (uint32_t& limb : result) {
+		limb = rng();
+	}
+	result.back() |= 1u << 31u;
+	return result;
+}
+
+bool starts_with(char const* arg, char const* prefix, char const*& value) {
+	size_t n = std::strlen(prefix);
+	if (std::strncmp(arg, prefix, n) != 0) {
+		return false;
+	}
+	value = arg + n;
+	return true;
+}
+}
+
+int main(int argc, char** argv) {
+	options opts;
+	for (int i = 1; i < argc; i++) {
+		char const* value = nullptr;
+		if (starts_with(argv[i], "--min_time=", value)) {
+			opts.min_time = std::atof(value);
+		} else if (starts_with(argv[i], "--max_time=", value)) {
+			opts.max_time = std::atof(value);
+		} else if (starts_with(argv[i], "--max_limbs=", value)) {
+			opts.max_limbs = static_cast<size_t>(std::atoll(value));
+		} else if (starts_with(argv[i], "--filter=", value)) {
+			opts.filter = value;
+		} else {
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::printf("{\n  \"context\": {\n");
+	std::printf("    \"executable\": \"%s\",\n", argv[0]);
+	std::printf("    \"library\": \"%s\",\n", BENCH_LIBRARY);
+	std::printf("    \"gmp_version\": \"%s\",\n", gmp_version);
+	std::printf("    \"min_time\": %g,\n    \"max_time\": %g\n  },\n", opts.min_time, opts.max_time);
+	std::printf("  \"benchmarks\": [");
+
+	std::mt19937 rng(46);
+	bool first_run = true;
+	bool too_slow[OPS][2] = {};
+	for (size_t n = 1; n <= opts.max_limbs; n *= 4) {
+		std::vector<uint32_t> a = random_limbs(n, rng), b = random_limbs(n, rng), wide = random_limbs(2 * n, rng);
+		std::fprintf(stderr, "%zu limbs\n", n);
+		operands<big_integer> mine = make_operands<big_integer>(a, b, wide);
+		operands<big_integer_gmp> gmp = make_operands<big_integer_gmp>(a, b, wide);
+		mine.decimal = gmp.decimal = to_string(gmp.a);
+		for (size_t i = 0; i < OPS; i++) {
+			op o = static_cast<op>(i);
+			std::string name = std::string(OP_NAMES[i]) + "/" + std::to_string(n);
+			if (name.find(opts.filter) == std::string::npos) {
+				continue;
+			}
+			timing t = measure(o, mine, opts, too_slow[i][0]);
+			timing g = measure(o, gmp, opts, too_slow[i][1]);
+			bool mismatch = false;
+			if (!t.skipped && n <= 256) {
+				std::string expected, actual;
+				run_once(o, mine, actual);
+				run_once(o, gmp, expected);
+				mismatch = actual != expected;
+			}
+			std::printf("%s\n    {\n", first_run ? "" : ",");
+			first_run = false;
+			std::printf("      \"name\": \"%s\",\n      \"run_name\": \"%s\",\n      \"run_type\": \"iteration\",\n",
+			            name.c_str(), name.c_str());
+			std::printf("      \"op\": \"%s\",\n      \"limbs\": %zu,\n", OP_NAMES[i], n);
+			if (t.skipped || mismatch) {
+				std::printf("      \"error_occurred\": true,\n      \"error_message\": \"%s\",\n",
+				            mismatch ? "result differs from GMP" : "skipped, the previous size was too slow for max_time");
+			} else {
+				std::printf("      \"iterations\": %zu,\n      \"real_time\": %.1f,\n", t.iterations, t.ns);
+			}
+			if (!g.skipped) {
+				std::printf("      \"gmp_iterations\": %zu,\n      \"gmp_time\": %.1f,\n", g.iterations, g.ns);
+				if (!t.skipped && !mismatch) {
+					std::printf("      \"ratio_to_gmp\": %.3f,\n", t.ns / g.ns);
+				}
+			}
+			std::printf("      \"time_unit\": \"ns\"\n    }");
+			std::fflush(stdout);
+		}
+	}
+	std::printf("\n  ]\n}\n");
+	return 0;
+}
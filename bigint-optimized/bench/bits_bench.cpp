@@ -0,0 +1,55 @@
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "bench_util.h"
+#include "big_integer.h"
+
+// Population count of long values: testing one bit at a time next to
+// popcount(), which runs a vector kernel where the CPU has one.
+
+namespace {
+size_t const TOTAL_LIMBS = 1 << 16;
+
+big_integer make_value(size_t limbs) {
+	std::string hex;
+	for (size_t i = 0; i < limbs; i++) {
+		hex += "9E3779B9";
+	}
+	return from_string(hex, 16);
+}
+
+size_t popcount_by_bits(big_integer const& x) {
+	size_t result = 0;
+	for (size_t i = 0, n = x.bit_length(); i < n; i++) {
+		result += x.test_bit(i);
+	}
+	return result;
+}
+
+void run(size_t limbs) {
+	big_integer x = make_value(limbs);
+	size_t iterations = TOTAL_LIMBS / limbs;
+	size_t p1 = 0, p2 = 0;
+	double bits = measure_ns(iterations, [&] {
+		p1 = popcount_by_bits(x);
+		do_not_optimize(p1);
+	});
+	double kernel = measure_ns(iterations * 64, [&] {
+		p2 = x.popcount();
+		do_not_optimize(p2);
+	});
+	if (p1 != p2) {
+		std::printf("mismatch at %zu limbs\n", limbs);
+	}
+	std::printf("%6zu %18.1f %18.1f\n", limbs, bits, kernel);
+}
+}
+
+int main() {
+	std::printf("%6s %18s %18s\n", "limbs", "test_bit ns", "popcount() ns");
+	for (size_t limbs : {4, 64, 1024, 4096}) {
+		run(limbs);
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "big_decimal.h"
+
+// Fixed point with 30 fractional digits the way it is emulated on
+// big_integer, a mantissa scaled by 10^30 with operator/ and operator%
+// to round half to even after every product and quotient and digits
+// printed by repeated / 10, next to big_decimal with its cached powers
+// of ten, a decimal_divisor prepared once and to_string.
+
+namespace {
+size_t const SCALE = 30;
+size_t const AMOUNTS = 1000;
+size_t const ROUNDS = 20;
+
+// Rounds a / d half to even for a positive d.
+big_integer round_half_even(big_integer const& a, big_integer const& d) {
+	big_integer q = a / d, r = a % d;
+	big_integer twice = abs(r) << 1;
+	if (twice > d || (twice == d && q.test_bit(0))) {
+		q += a < 0 ? -1 : 1;
+	}
+	return q;
+}
+
+std::string print_by_tens(big_integer a) {
+	std::string digits;
+	do {
+		digits += to_string(a % 10);
+		a /= 10;
+	} while (a != 0);
+	std::reverse(digits.begin(), digits.end());
+	digits.insert(digits.size() - SCALE, 1, '.');
+	return digits;
+}
+
+void run(size_t limbs, std::mt19937& rng) {
+	big_integer const one = big_decimal::power_of_ten(SCALE).value();
+	std::vector<big_decimal> amounts;
+	for (size_t i = 0; i < AMOUNTS; i++) {
+		amounts.emplace_back(random_big_integer(limbs, rng) + one, SCALE);
+	}
+	big_decimal const rate(random_big_integer(4, rng), SCALE);
+	decimal_divisor const prepared(rate);
+
+	big_integer sum1, sum2;
+	double plain_mul = measure_ns(ROUNDS, [&] {
+		for (big_decimal const& a : amounts) {
+			sum1 += round_half_even(a.mantissa() * rate.mantissa(), one);
+		}
+	}) / AMOUNTS;
+	double decimal_mul = measure_ns(ROUNDS, [&] {
+		for (big_decimal const& a : amounts) {
+			sum2 += (a * rate).rescale(SCALE).mantissa();
+		}
+	}) / AMOUNTS;
+	double plain_div = measure_ns(ROUNDS, [&] {
+		for (big_decimal const& a : amounts) {
+			sum1 += round_half_even(a.mantissa() * one, rate.mantissa());
+		}
+	}) / AMOUNTS;
+	double decimal_div = measure_ns(ROUNDS, [&] {
+		for (big_decimal const& a : amounts) {
+			sum2 += divide(a, prepared, SCALE).mantissa();
+		}
+	}) / AMOUNTS;
+	size_t length1 = 0, length2 = 0;
+	double plain_print = measure_ns(1, [&] {
+		for (big_decimal const& a : amounts) {
+			length1 += print_by_tens(a.mantissa()).size();
+		}
+	}) / AMOUNTS;
+	double decimal_print = measure_ns(1, [&] {
+		for (big_decimal const& a : amounts) {
+			length2 += to_string(a).size();
+		}
+	}) / AMOUNTS;
+	if (sum1 != sum2 || length1 != length2) {
+		std::printf("mismatch at %zu limbs\n", limbs);
+	}
+	std::printf("%6zu %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f\n", limbs, plain_mul, decimal_mul, plain_div,
+	            decimal_div, plain_print, decimal_print);
+}
+}
+
+int main() {
+	std::mt19937 rng(50);
+	std::printf("%6s %10s %10s %10s %10s %10s %10s\n", "limbs", "mul ns", "decimal", "div ns", "decimal",
+	            "print ns", "decimal");
+	for (size_t limbs : {2, 4, 8, 32, 128}) {
+		run(limbs, rng);
+	}
+	return 0;
+}
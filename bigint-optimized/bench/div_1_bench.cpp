@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "limb_kernels.h"
+
+// Dividing a limb array by a single limb: a hardware 64/32 division per
+// limb next to the reciprocal kernel, with the reciprocal built for every
+// call and reused across calls.
+
+namespace {
+size_t const TOTAL_LIMBS = 1 << 20;
+
+uint32_t hardware_divrem_1(uint32_t* q, uint32_t const* a, size_t n, uint32_t d) {
+	uint64_t rem = 0;
+	for (size_t i = n; i > 0; i--) {
+		uint64_t cur = (rem << 32u) | a[i - 1];
+		q[i - 1] = static_cast<uint32_t>(cur / d);
+		rem = cur % d;
+	}
+	return static_cast<uint32_t>(rem);
+}
+
+void run(size_t n, uint32_t d, std::mt19937& rng) {
+	std::vector<uint32_t> a(n), q(n);
+	for (uint32_t& limb : a) {
+		limb = rng();
+	}
+	size_t iterations = TOTAL_LIMBS / n;
+	uint32_t r1 = 0, r2 = 0, r3 = 0;
+	double hardware = measure_ns(iterations, [&] {
+		r1 = hardware_divrem_1(q.data(), a.data(), n, d);
+		do_not_optimize(q);
+	}) / n;
+	double fresh = measure_ns(iterations, [&] {
+		r2 = limbs::divrem_1(q.data(), a.data(), n, d);
+		do_not_optimize(q);
+	}) / n;
+	limbs::divisor_1 const divisor(d);
+	double reused = measure_ns(iterations, [&] {
+		r3 = limbs::divrem_1(q.data(), a.data(), n, divisor);
+		do_not_optimize(q);
+	}) / n;
+	if (r1 != r2 || r1 != r3) {
+		std::printf("mismatch at %zu limbs\n", n);
+	}
+	std::printf("%6zu %10u %14.2f %14.2f %14.2f\n", n, d, hardware, fresh, reused);
+}
+}
+
+int main() {
+	std::mt19937 rng(12345);
+	std::printf("%6s %10s %14s %14s %14s\n", "limbs", "divisor", "hw ns/limb", "fresh ns/limb", "reused ns/limb");
+	for (size_t n : {1, 4, 64, 1024}) {
+		run(n, 1000000000, rng);
+		run(n, 0xFFFFFFFB, rng);
+	}
+	return 0;
+}
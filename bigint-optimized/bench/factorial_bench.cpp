@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <cstdio>
+
+#include "bench_util.h"
+#include "number_theory.h"
+
+// n! as a loop of small multiplications next to the prime factorization,
+// and C(2n, n) from the factorization alone.
+
+namespace {
+void run(uint32_t n, bool with_loop) {
+	big_integer loop_result;
+	double loop = 0;
+	if (with_loop) {
+		loop = measure_ns(1, [&] {
+			loop_result = 1;
+			for (uint32_t i = 2; i <= n; i++) {
+				loop_result *= i;
+			}
+			do_not_optimize(loop_result);
+		});
+	}
+
+	big_integer fast_result;
+	double fast = measure_ns(1, [&] {
+		fast_result = factorial(n);
+		do_not_optimize(fast_result);
+	});
+
+	big_integer central;
+	double binom = measure_ns(1, [&] {
+		central = binomial(2 * n, n);
+		do_not_optimize(central);
+	});
+
+	if (with_loop && loop_result != fast_result) {
+		std::printf("mismatch at %u\n", n);
+	}
+	std::printf("%9u %12.3f %12.3f %12.3f\n", n, loop / 1e6, fast / 1e6, binom / 1e6);
+}
+}
+
+int main() {
+	std::printf("%9s %12s %12s %12s\n", "n", "loop ms", "n! ms", "C(2n,n) ms");
+	run(10000, true);
+	run(50000, true);
+	run(100000, true);
+	run(300000, false);
+	return 0;
+}
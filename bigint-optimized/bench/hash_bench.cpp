@@ -0,0 +1,51 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_util.h"
+
+// Insert and lookup cost of big_integer keys in std::unordered_set with the
+// limb hash, next to the old workaround of hashing to_string(x).
+
+namespace {
+struct decimal_hash {
+	size_t operator()(big_integer const& a) const {
+		return std::hash<std::string>()(to_string(a));
+	}
+};
+
+template<typename Hash>
+void run(char const* name, size_t limbs, std::vector<big_integer> const& keys) {
+	std::unordered_set<big_integer, Hash> set;
+	set.reserve(keys.size());
+	double insert = measure_ns(1, [&] {
+		for (big_integer const& k : keys) {
+			set.insert(k);
+		}
+	}) / keys.size();
+	size_t found = 0;
+	double lookup = measure_ns(1, [&] {
+		for (big_integer const& k : keys) {
+			found += set.count(k);
+		}
+	}) / keys.size();
+	do_not_optimize(found);
+	std::printf("%-12s %8zu %14.1f %14.1f\n", name, limbs, insert, lookup);
+}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::printf("%-12s %8s %14s %14s\n", "hash", "limbs", "ns/insert", "ns/lookup");
+	for (size_t limbs : {1, 4, 16, 64, 256}) {
+		std::vector<big_integer> keys;
+		for (size_t i = 0; i < 200000 / limbs; i++) {
+			keys.push_back(random_big_integer(limbs, rng));
+		}
+		run<std::hash<big_integer>>("limb", limbs, keys);
+		run<decimal_hash>("to_string", limbs, keys);
+	}
+	return 0;
+}
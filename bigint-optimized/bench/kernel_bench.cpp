@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "limb_dispatch.h"
+
+// The limb kernels of every instruction set tier this CPU supports, in ns
+// per limb, after the name of the table the library picked. Set
+// BIGINT_CPU_TIER to generic, bmi2_adx, avx2 or avx512 to force a lower one.
+
+namespace {
+size_t const LIMBS = 1024;
+size_t const ITERATIONS = 4096;
+
+void run(limbs::kernel_table const& k, std::mt19937& rng) {
+	std::vector<uint32_t> a(LIMBS), b(LIMBS), r(LIMBS);
+	for (size_t i = 0; i < LIMBS; i++) {
+		a[i] = rng();
+		b[i] = rng();
+	}
+	uint32_t m = rng();
+	size_t sink = 0;
+	double add = measure_ns(ITERATIONS, [&] {
+		sink += k.add_n(r.data(), a.data(), b.data(), LIMBS);
+		do_not_optimize(r);
+	}) / LIMBS;
+	double sub = measure_ns(ITERATIONS, [&] {
+		sink += k.sub_n(r.data(), a.data(), b.data(), LIMBS);
+		do_not_optimize(r);
+	}) / LIMBS;
+	double mul = measure_ns(ITERATIONS, [&] {
+		sink += k.mul_1(r.data(), a.data(), LIMBS, m);
+		do_not_optimize(r);
+	}) / LIMBS;
+	double addmul = measure_ns(ITERATIONS, [&] {
+		sink += k.addmul_1(r.data(), a.data(), LIMBS, m);
+		do_not_optimize(r);
+	}) / LIMBS;
+	double bitwise = measure_ns(ITERATIONS, [&] {
+		k.xor_n(r.data(), a.data(), b.data(), LIMBS);
+		do_not_optimize(r);
+	}) / LIMBS;
+	double popcount = measure_ns(ITERATIONS, [&] {
+		sink += k.popcount(a.data(), LIMBS);
+	}) / LIMBS;
+	do_not_optimize(sink);
+	std::printf("%-10s %8.3f %8.3f %8.3f %9.3f %8.3f %9.3f\n", k.name, add, sub, mul, addmul, bitwise, popcount);
+}
+}
+
+int main() {
+	std::mt19937 rng(44);
+	std::printf("selected kernels: %s (supported: %s)\n", limbs::kernels().name,
+	            limbs::kernels(limbs::supported_tier()).name);
+	std::printf("%-10s %8s %8s %8s %9s %8s %9s\n", "tier", "add_n", "sub_n", "mul_1", "addmul_1", "xor_n", "popcount");
+	for (limbs::cpu_tier tier : {limbs::cpu_tier::generic, limbs::cpu_tier::bmi2_adx,
+	                             limbs::cpu_tier::avx2, limbs::cpu_tier::avx512}) {
+		if (tier <= limbs::supported_tier()) {
+			run(limbs::kernels(tier), rng);
+		}
+	}
+	return 0;
+}
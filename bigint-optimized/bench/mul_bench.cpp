@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "thread_pool.h"
+
+// Squaring and multiplying numbers of growing size with the thread limit
+// going from 1 to the number of cores, to see how far the forked
+// Karatsuba branches scale.
+
+namespace {
+// random_big_integer is quadratic in the length, go through hex instead.
+big_integer random_huge(size_t limbs, std::mt19937& rng) {
+	std::string hex(8 * limbs, '0');
+	for (char& c : hex) {
+		c = "0123456789abcdef"[rng() % 16];
+	}
+	hex[0] = '1';
+	return from_string(hex, 16);
+}
+
+void run(size_t limbs, size_t max_threads, std::mt19937& rng) {
+	big_integer a = random_huge(limbs, rng);
+	big_integer b = random_huge(limbs, rng);
+	size_t iterations = limbs >= 100000 ? 1 : 5;
+	double serial = 0;
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		scoped_thread_limit limit(threads);
+		big_integer product;
+		double square = measure_ns(iterations, [&] {
+			product = a * a;
+			do_not_optimize(product);
+		});
+		double mul = measure_ns(iterations, [&] {
+			product = a * b;
+			do_not_optimize(product);
+		});
+		if (threads == 1) {
+			serial = mul;
+		}
+		std::printf("%8zu %8zu %12.3f %12.3f %8.2f\n", limbs, threads, square / 1e6, mul / 1e6, serial / mul);
+	}
+}
+}
+
+int main() {
+	std::mt19937 rng(12345);
+	size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::printf("%8s %8s %12s %12s %8s\n", "limbs", "threads", "square ms", "mul ms", "speedup");
+	for (size_t limbs : {1000, 10000, 100000, 300000}) {
+		run(limbs, max_threads, rng);
+	}
+	return 0;
+}
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <random>
+
+#include "bench_util.h"
+#include "number_theory.h"
+
+// A base-2 Fermat test written with the big_integer operators next to one
+// Montgomery-form Miller-Rabin round and the whole BPSW test on a prime of
+// the given size, and the time next_prime takes to find that prime after a
+// random start.
+
+namespace {
+size_t const ROUNDS = 8;
+
+big_integer pow_mod(big_integer base, big_integer e, big_integer const& m) {
+	big_integer result = 1;
+	while (e != 0) {
+		if ((e & 1) != 0) {
+			result = result * base % m;
+		}
+		base = base * base % m;
+		e >>= 1;
+	}
+	return result;
+}
+
+void run(size_t limbs, std::mt19937& rng) {
+	big_integer start = random_big_integer(limbs, rng);
+	big_integer prime;
+	double next = measure_ns(1, [&] {
+		prime = next_prime(start);
+		do_not_optimize(prime);
+	});
+
+	big_integer fermat;
+	double naive = measure_ns(1, [&] {
+		fermat = pow_mod(2, prime - 1, prime);
+		do_not_optimize(fermat);
+	});
+
+	bool passed = false;
+	double bpsw = measure_ns(3, [&] {
+		passed = is_probable_prime(prime);
+		do_not_optimize(passed);
+	});
+	double with_rounds = measure_ns(1, [&] {
+		passed = passed && is_probable_prime(prime, ROUNDS);
+		do_not_optimize(passed);
+	});
+	double round = (with_rounds - bpsw) / ROUNDS;
+
+	if (fermat != 1 || !passed) {
+		std::printf("mismatch at %zu limbs\n", limbs);
+	}
+	std::printf("%6zu %14.3f %14.3f %14.3f %14.3f\n", 32 * limbs, naive / 1e6, round / 1e6, bpsw / 1e6, next / 1e6);
+}
+}
+
+int main() {
+	std::mt19937 rng(12345);
+	std::printf("%6s %14s %14s %14s %14s\n", "bits", "operators ms", "mr round ms", "bpsw ms", "next_prime ms");
+	for (size_t limbs : {8, 16, 32, 64}) {
+		run(limbs, rng);
+	}
+	return 0;
+}
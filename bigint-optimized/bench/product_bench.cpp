@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "thread_pool.h"
+
+// Multiplying a column of factors together: the left-to-right loop next to
+// the balanced product tree, serial and with one thread per core.
+
+namespace {
+void run(size_t count, size_t limbs, std::mt19937& rng) {
+	std::vector<big_integer> factors;
+	for (size_t i = 0; i < count; i++) {
+		factors.push_back(random_big_integer(limbs, rng));
+	}
+
+	big_integer naive;
+	double loop = measure_ns(1, [&] {
+		naive = 1;
+		for (big_integer const& factor : factors) {
+			naive *= factor;
+		}
+		do_not_optimize(naive);
+	});
+
+	big_integer tree;
+	double serial = measure_ns(1, [&] {
+		tree = product(factors.begin(), factors.end());
+		do_not_optimize(tree);
+	});
+
+	scoped_thread_limit limit(0);
+	double parallel = measure_ns(1, [&] {
+		tree = product(factors.begin(), factors.end());
+		do_not_optimize(tree);
+	});
+
+	if (tree != naive) {
+		std::printf("mismatch at %zu x %zu\n", count, limbs);
+	}
+	std::printf("%8zu %6zu %12.3f %12.3f %12.3f\n", count, limbs, loop / 1e6, serial / 1e6, parallel / 1e6);
+}
+}
+
+int main() {
+	std::mt19937 rng(12345);
+	std::printf("threads: %u\n", std::max(std::thread::hardware_concurrency(), 1u));
+	std::printf("%8s %6s %12s %12s %12s\n", "factors", "limbs", "loop ms", "tree ms", "parallel ms");
+	run(10000, 1, rng);
+	run(30000, 1, rng);
+	run(2000, 16, rng);
+	run(500, 256, rng);
+	return 0;
+}
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "big_rational.h"
+#include "number_theory.h"
+
+// Sums of fractions, the harmonic numbers H(n) and a sum of random
+// fractions with a few limbs each: big_rational, which reduces lazily,
+// next to a fraction reduced by a GCD after every addition.
+
+namespace {
+struct eager_rational {
+	big_integer num = 0;
+	big_integer den = 1;
+
+	eager_rational& operator+=(eager_rational const& b) {
+		num = num * b.den + b.num * den;
+		den *= b.den;
+		big_integer g = gcd(num, den);
+		num /= g;
+		den /= g;
+		return *this;
+	}
+};
+
+template<typename F>
+void run(char const* name, size_t n, F&& term) {
+	big_rational lazy;
+	eager_rational eager;
+	double lazy_ns = measure_ns(1, [&] {
+		for (size_t i = 1; i <= n; i++) {
+			lazy += term(i);
+		}
+		do_not_optimize(lazy.reduce());
+	});
+	double eager_ns = measure_ns(1, [&] {
+		for (size_t i = 1; i <= n; i++) {
+			big_rational t = term(i);
+			t.reduce();
+			eager += eager_rational{t.numerator(), t.denominator()};
+		}
+	});
+	if (lazy.numerator() != eager.num || lazy.denominator() != eager.den) {
+		std::printf("mismatch in %s(%zu)\n", name, n);
+	}
+	std::printf("%-10s %6zu %14.0f %14.0f\n", name, n, lazy_ns / 1000, eager_ns / 1000);
+}
+}
+
+int main() {
+	std::mt19937 rng(49);
+	std::vector<big_rational> fractions;
+	for (size_t i = 0; i < 1000; i++) {
+		fractions.emplace_back(random_big_integer(3, rng), random_big_integer(2, rng));
+	}
+	std::printf("%-10s %6s %14s %14s\n", "sum", "terms", "lazy us", "eager us");
+	for (size_t n : {100, 1000, 4000}) {
+		run("harmonic", n, [](size_t i) { return big_rational(1, static_cast<int>(i)); });
+	}
+	for (size_t n : {100, 300, 1000}) {
+		run("random", n, [&](size_t i) { return fractions[i - 1]; });
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "serialization.h"
+
+// Checkpoint round trip of a million values through a stream, in the
+// binary record format and as decimal text.
+
+int main() {
+	std::mt19937 rng(42);
+	size_t const count = 1000000;
+	std::printf("%-10s %8s %14s %14s %12s\n", "format", "limbs", "ns/write", "ns/read", "bytes");
+	for (size_t limbs : {1, 4, 16}) {
+		std::vector<big_integer> values;
+		for (size_t i = 0; i < count / limbs; i++) {
+			values.push_back(random_big_integer(limbs, rng));
+		}
+
+		std::stringstream binary;
+		double write = measure_ns(1, [&] {
+			big_integer_writer writer(binary);
+			for (big_integer const& v : values) {
+				writer.write(v);
+			}
+		}) / values.size();
+		size_t bytes = binary.str().size();
+		double read = measure_ns(1, [&] {
+			big_integer_reader reader(binary);
+			big_integer v;
+			while (reader.read(v)) {
+				do_not_optimize(v);
+			}
+		}) / values.size();
+		std::printf("%-10s %8zu %14.1f %14.1f %12zu\n", "binary", limbs, write, read, bytes);
+
+		std::stringstream text;
+		write = measure_ns(1, [&] {
+			for (big_integer const& v : values) {
+				text << to_string(v) << '\n';
+			}
+		}) / values.size();
+		bytes = text.str().size();
+		read = measure_ns(1, [&] {
+			std::string line;
+			while (std::getline(text, line)) {
+				big_integer v(line);
+				do_not_optimize(v);
+			}
+		}) / values.size();
+		std::printf("%-10s %8zu %14.1f %14.1f %12zu\n", "decimal", limbs, write, read, bytes);
+	}
+	return 0;
+}
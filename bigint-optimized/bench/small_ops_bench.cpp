@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+
+// Single-limb operands: each operation on int64_t as the floor, on two
+// big_integer values and on a big_integer with an int64_t right operand.
+
+namespace {
+size_t const COUNT = 4096;
+size_t const ITERATIONS = 200;
+
+template<typename Op>
+void run(char const* name, std::vector<int64_t> const& a, std::vector<int64_t> const& b, Op op) {
+	std::vector<big_integer> big_a(a.begin(), a.end()), big_b(b.begin(), b.end());
+
+	int64_t native_result = 0;
+	double native = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			native_result = op(a[i], b[i]);
+			do_not_optimize(native_result);
+		}
+	}) / COUNT;
+
+	big_integer result;
+	double big = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			result = op(big_a[i], big_b[i]);
+			do_not_optimize(result);
+		}
+	}) / COUNT;
+
+	double mixed = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			result = op(big_a[i], b[i]);
+			do_not_optimize(result);
+		}
+	}) / COUNT;
+
+	if (result != native_result) {
+		std::printf("mismatch in %s\n", name);
+	}
+	std::printf("%-6s %10.2f %10.2f %10.2f\n", name, native, big, mixed);
+}
+}
+
+int main() {
+	std::mt19937 rng(12345);
+	std::vector<int64_t> a, b;
+	for (size_t i = 0; i < COUNT; i++) {
+		a.push_back(static_cast<int32_t>(rng()));
+		b.push_back(static_cast<int32_t>(rng() | 1u));
+	}
+
+	std::printf("%-6s %10s %10s %10s\n", "op", "int64_t", "big", "big/int");
+	run("add", a, b, [](auto const& x, auto const& y) { return x + y; });
+	run("sub", a, b, [](auto const& x, auto const& y) { return x - y; });
+	run("mul", a, b, [](auto const& x, auto const& y) { return x * y; });
+	run("div", a, b, [](auto const& x, auto const& y) { return x / y; });
+	run("mod", a, b, [](auto const& x, auto const& y) { return x % y; });
+	run("less", a, b, [](auto const& x, auto const& y) -> int64_t { return x < y; });
+	return 0;
+}
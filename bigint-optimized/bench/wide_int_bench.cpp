@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "wide_int.h"
+
+// Add, multiply and divide fixed-width values held in wide_uint next to the
+// same values held in big_integer. Products are reduced back to the width
+// so that both sides keep operating on numbers of the same size.
+
+namespace {
+size_t const COUNT = 4096;
+size_t const ITERATIONS = 50;
+
+template<size_t Bits>
+void run(std::mt19937& rng) {
+	std::vector<big_integer> a, b;
+	std::vector<wide_uint<Bits>> wa, wb;
+	big_integer const mask = (big_integer(1) << static_cast<int>(Bits)) - 1;
+	for (size_t i = 0; i < COUNT; i++) {
+		a.push_back(random_big_integer(Bits / 32, rng));
+		b.push_back(random_big_integer(Bits / 64, rng));
+		wa.emplace_back(a.back());
+		wb.emplace_back(b.back());
+	}
+
+	big_integer sum;
+	double add = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			sum = a[i] + b[i];
+		}
+		do_not_optimize(sum);
+	}) / COUNT;
+	wide_uint<Bits> wide_sum;
+	double wide_add = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			wide_sum = wa[i] + wb[i];
+			do_not_optimize(wide_sum);
+		}
+	}) / COUNT;
+
+	big_integer product;
+	double mul = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			product = a[i] * b[i] & mask;
+		}
+		do_not_optimize(product);
+	}) / COUNT;
+	wide_uint<Bits> wide_product;
+	double wide_mul = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			wide_product = wa[i] * wb[i];
+			do_not_optimize(wide_product);
+		}
+	}) / COUNT;
+
+	big_integer quotient;
+	double div = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			quotient = a[i] / b[i];
+		}
+		do_not_optimize(quotient);
+	}) / COUNT;
+	wide_uint<Bits> wide_quotient;
+	double wide_div = measure_ns(ITERATIONS, [&] {
+		for (size_t i = 0; i < COUNT; i++) {
+			wide_quotient = wa[i] / wb[i];
+			do_not_optimize(wide_quotient);
+		}
+	}) / COUNT;
+
+	if (big_integer(wide_product) != product || big_integer(wide_quotient) != quotient) {
+		std::printf("mismatch at %zu bits\n", Bits);
+	}
+	std::printf("%6zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", Bits, add, wide_add, mul, wide_mul, div, wide_div);
+}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::printf("ns per operation\n");
+	std::printf("%6s %10s %10s %10s %10s %10s %10s\n", "bits", "add", "wide_add", "mul", "wide_mul", "div", "wide_div");
+	run<128>(rng);
+	run<256>(rng);
+	run<512>(rng);
+	return 0;
+}
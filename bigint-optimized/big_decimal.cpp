@@ -0,0 +1,237 @@
+#include "big_decimal.h"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+// q and r of a truncating division by d, moved one step away from zero
+// when the mode asks for it. negative is the sign of the exact quotient,
+// which q does not carry when it is zero.
+big_integer round_quotient(big_integer q, big_integer const& r, big_integer const& d, bool negative,
+                           rounding_mode mode) {
+	if (r == 0) {
+		return q;
+	}
+	bool away = false;
+	switch (mode) {
+	case rounding_mode::up:
+		away = true;
+		break;
+	case rounding_mode::down:
+		break;
+	case rounding_mode::ceiling:
+		away = !negative;
+		break;
+	case rounding_mode::floor:
+		away = negative;
+		break;
+	default: {
+		// 2|r| against |d|, with the sign of d so that d is not copied.
+		big_integer twice = r << 1;
+		if ((twice < 0) != (d < 0)) {
+			twice = -twice;
+		}
+		int half = twice == d ? 0 : (twice > d) != (d < 0) ? 1 : -1;
+		away = half > 0
+		       || (half == 0 && (mode == rounding_mode::half_up
+		                          || (mode == rounding_mode::half_even && q.test_bit(0))));
+	}
+	}
+	if (away) {
+		q += negative ? -1 : 1;
+	}
+	return q;
+}
+
+big_integer divide_rounded(big_integer const& a, big_divisor const& d, rounding_mode mode) {
+	if (mode == rounding_mode::down) {
+		return divide(a, d);
+	}
+	big_integer q, r;
+	div_mod(a, d, q, r);
+	return round_quotient(std::move(q), r, d.value(), (a < 0) != (d.value() < 0), mode);
+}
+
+big_integer power(big_integer base, size_t exponent) {
+	big_integer result = 1;
+	for (; exponent; exponent >>= 1u) {
+		if (exponent & 1u) {
+			result *= base;
+		}
+		if (exponent > 1) {
+			base *= base;
+		}
+	}
+	return result;
+}
+}
+
+big_decimal::big_decimal() : mantissa_(0), scale_(0) {}
+
+big_decimal::big_decimal(int a) : mantissa_(a), scale_(0) {}
+
+big_decimal::big_decimal(big_integer const& mantissa, size_t scale) : mantissa_(mantissa), scale_(scale) {}
+
+big_decimal::big_decimal(std::string const& str) : big_decimal() {
+	size_t first = str.empty() || (str[0] != '+' && str[0] != '-') ? 0 : 1;
+	size_t point = str.find('.');
+	size_t integer_digits = (point == std::string::npos ? str.size() : point) - first;
+	size_t fraction_digits = point == std::string::npos ? 0 : str.size() - point - 1;
+	bool digits_only = std::all_of(str.begin() + first, str.end(), [](char c) {
+		return c == '.' || (c >= '0' && c <= '9');
+	});
+	if (!digits_only || integer_digits + fraction_digits == 0
+	    || (point != std::string::npos && str.find('.', point + 1) != std::string::npos)) {
+		throw std::runtime_error("Expected decimal, actual: " + str);
+	}
+	std::string digits = str.substr(0, first);
+	digits += integer_digits ? str.substr(first, integer_digits) : "0";
+	if (fraction_digits) {
+		digits += str.substr(point + 1);
+	}
+	mantissa_ = big_integer(digits);
+	scale_ = fraction_digits;
+}
+
+big_divisor const& big_decimal::power_of_ten(size_t k) {
+	static thread_local std::unordered_map<size_t, big_divisor> powers;
+	auto it = powers.find(k);
+	if (it == powers.end()) {
+		scoped_limb_resource default_resource(nullptr);
+		it = powers.emplace(k, big_divisor(power(10, k))).first;
+	}
+	return it->second;
+}
+
+big_integer big_decimal::aligned(big_decimal const& a, size_t scale) {
+	return scale == a.scale_ ? a.mantissa_ : a.mantissa_ * power_of_ten(scale - a.scale_).value();
+}
+
+big_decimal& big_decimal::rescale(size_t scale, rounding_mode mode) {
+	if (scale >= scale_) {
+		mantissa_ = aligned(*this, scale);
+	} else {
+		mantissa_ = divide_rounded(mantissa_, power_of_ten(scale_ - scale), mode);
+	}
+	scale_ = scale;
+	return *this;
+}
+
+big_decimal& big_decimal::operator+=(big_decimal const& rhs) {
+	if (scale_ == rhs.scale_) {
+		mantissa_ += rhs.mantissa_;
+	} else if (scale_ > rhs.scale_) {
+		mantissa_ += aligned(rhs, scale_);
+	} else {
+		mantissa_ = aligned(*this, rhs.scale_) + rhs.mantissa_;
+		scale_ = rhs.scale_;
+	}
+	return *this;
+}
+
+big_decimal& big_decimal::operator-=(big_decimal const& rhs) {
+	return *this += -rhs;
+}
+
+big_decimal& big_decimal::operator*=(big_decimal const& rhs) {
+	mantissa_ *= rhs.mantissa_;
+	scale_ += rhs.scale_;
+	return *this;
+}
+
+big_decimal big_decimal::operator+() const {
+	return *this;
+}
+
+big_decimal big_decimal::operator-() const {
+	return big_decimal(-mantissa_, scale_);
+}
+
+big_decimal operator+(big_decimal a, big_decimal const& b) {
+	return a += b;
+}
+
+big_decimal operator-(big_decimal a, big_decimal const& b) {
+	return a -= b;
+}
+
+big_decimal operator*(big_decimal a, big_decimal const& b) {
+	return a *= b;
+}
+
+decimal_divisor::decimal_divisor(big_decimal const& d) : mantissa_(d.mantissa()), scale_(d.scale()) {}
+
+// The quotient at the given scale is a * 10^(scale + d.scale - a.scale) / d.
+// When the exponent is negative the power of ten divides instead, first
+// on its own and then the divisor takes the rest; truncation composes, so
+// only the remainder has to be put back together for the rounding.
+big_decimal divide(big_decimal const& a, decimal_divisor const& d, size_t scale, rounding_mode mode) {
+	if (scale + d.scale_ >= a.scale()) {
+		big_integer n = a.mantissa() * big_decimal::power_of_ten(scale + d.scale_ - a.scale()).value();
+		return big_decimal(divide_rounded(n, d.mantissa_, mode), scale);
+	}
+	big_divisor const& ten_k = big_decimal::power_of_ten(a.scale() - scale - d.scale_);
+	big_integer q1, r1, q2, r2;
+	div_mod(a.mantissa(), ten_k, q1, r1);
+	div_mod(q1, d.mantissa_, q2, r2);
+	big_integer r = r2 * ten_k.value() + r1;
+	big_integer divisor = d.mantissa_.value() * ten_k.value();
+	bool negative = (a.mantissa() < 0) != (d.mantissa_.value() < 0);
+	return big_decimal(round_quotient(std::move(q2), r, divisor, negative, mode), scale);
+}
+
+big_decimal divide(big_decimal const& a, big_decimal const& d, size_t scale, rounding_mode mode) {
+	return divide(a, decimal_divisor(d), scale, mode);
+}
+
+int big_decimal::compare(big_decimal const& a, big_decimal const& b) {
+	size_t scale = std::max(a.scale_, b.scale_);
+	big_integer x = aligned(a, scale), y = aligned(b, scale);
+	return x < y ? -1 : x == y ? 0 : 1;
+}
+
+bool operator==(big_decimal const& a, big_decimal const& b) {
+	if (a.scale_ == b.scale_) {
+		return a.mantissa_ == b.mantissa_;
+	}
+	return big_decimal::compare(a, b) == 0;
+}
+
+bool operator!=(big_decimal const& a, big_decimal const& b) {
+	return !(a == b);
+}
+
+bool operator<(big_decimal const& a, big_decimal const& b) {
+	return big_decimal::compare(a, b) < 0;
+}
+
+bool operator>(big_decimal const& a, big_decimal const& b) {
+	return big_decimal::compare(a, b) > 0;
+}
+
+bool operator<=(big_decimal const& a, big_decimal const& b) {
+	return big_decimal::compare(a, b) <= 0;
+}
+
+bool operator>=(big_decimal const& a, big_decimal const& b) {
+	return big_decimal::compare(a, b) >= 0;
+}
+
+// The digits come from the radix conversion of the mantissa in one go, the
+// point is put in afterwards.
+std::string to_string(big_decimal const& a) {
+	std::string digits = to_string(abs(a.mantissa_));
+	if (a.scale_ > 0) {
+		if (digits.size() <= a.scale_) {
+			digits.insert(0, a.scale_ + 1 - digits.size(), '0');
+		}
+		digits.insert(digits.size() - a.scale_, 1, '.');
+	}
+	return a.mantissa_ < 0 ? "-" + digits : digits;
+}
+
+std::ostream& operator<<(std::ostream& s, big_decimal const& a) {
+	return s << to_string(a);
+}
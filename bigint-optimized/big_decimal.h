@@ -0,0 +1,119 @@
+#ifndef BIGINT_BIG_DECIMAL_H
+#define BIGINT_BIG_DECIMAL_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include "big_divisor.h"
+#include "big_integer.h"
+
+// How a result that does not fit the requested scale is rounded, with
+// the meaning of the RoundingMode of the same name in Java: up and down
+// are away from and towards zero, the half_ modes round to the nearest
+// and differ only in ties.
+enum class rounding_mode {
+	up,
+	down,
+	ceiling,
+	floor,
+	half_up,
+	half_down,
+	half_even,
+};
+
+// Decimal fixed point: the value mantissa * 10^-scale. Addition,
+// subtraction and multiplication are exact and give the larger scale and
+// the sum of the scales respectively; rescale() and divide() round to a
+// given scale. Dividing by a power of ten goes through a big_divisor
+// cached per exponent, so rounding back after a multiplication costs no
+// normalization of the divisor. The scale is kept as given, 1.50 and 1.5
+// compare equal but print differently.
+class big_decimal {
+public:
+	big_decimal();
+	big_decimal(int a);
+	big_decimal(big_integer const& mantissa, size_t scale = 0);
+	// "-12.3400" and the like, an optional sign, digits and an optional
+	// fraction. Throws std::runtime_error for anything else.
+	explicit big_decimal(std::string const& str);
+
+	big_integer const& mantissa() const {
+		return mantissa_;
+	}
+
+	size_t scale() const {
+		return scale_;
+	}
+
+	// Changes the scale, rounding when digits are dropped.
+	big_decimal& rescale(size_t scale, rounding_mode mode = rounding_mode::half_even);
+
+	big_decimal& operator+=(big_decimal const& rhs);
+	big_decimal& operator-=(big_decimal const& rhs);
+	big_decimal& operator*=(big_decimal const& rhs);
+
+	big_decimal operator+() const;
+	big_decimal operator-() const;
+
+	friend bool operator==(big_decimal const& a, big_decimal const& b);
+	friend bool operator!=(big_decimal const& a, big_decimal const& b);
+	friend bool operator<(big_decimal const& a, big_decimal const& b);
+	friend bool operator>(big_decimal const& a, big_decimal const& b);
+	friend bool operator<=(big_decimal const& a, big_decimal const& b);
+	friend bool operator>=(big_decimal const& a, big_decimal const& b);
+
+	friend std::string to_string(big_decimal const& a);
+
+	// 10^k, prepared for division. The table is per thread and keeps
+	// every exponent asked for.
+	static big_divisor const& power_of_ten(size_t k);
+
+private:
+	big_integer mantissa_;
+	size_t scale_;
+
+	// The mantissa of a at a scale no smaller than its own.
+	static big_integer aligned(big_decimal const& a, size_t scale);
+	static int compare(big_decimal const& a, big_decimal const& b);
+};
+
+// A divisor prepared once for dividing many decimals, the mantissa as a
+// big_divisor along with the scale.
+class decimal_divisor {
+public:
+	// Throws std::runtime_error for zero.
+	explicit decimal_divisor(big_decimal const& d);
+
+	big_decimal value() const {
+		return big_decimal(mantissa_.value(), scale_);
+	}
+
+private:
+	big_divisor mantissa_;
+	size_t scale_;
+
+	friend big_decimal divide(big_decimal const& a, decimal_divisor const& d, size_t scale, rounding_mode mode);
+};
+
+big_decimal operator+(big_decimal a, big_decimal const& b);
+big_decimal operator-(big_decimal a, big_decimal const& b);
+big_decimal operator*(big_decimal a, big_decimal const& b);
+
+// a / d rounded to the given scale. Throws std::runtime_error for d = 0.
+big_decimal divide(big_decimal const& a, decimal_divisor const& d, size_t scale,
+                   rounding_mode mode = rounding_mode::half_even);
+big_decimal divide(big_decimal const& a, big_decimal const& d, size_t scale,
+                   rounding_mode mode = rounding_mode::half_even);
+
+bool operator==(big_decimal const& a, big_decimal const& b);
+bool operator!=(big_decimal const& a, big_decimal const& b);
+bool operator<(big_decimal const& a, big_decimal const& b);
+bool operator>(big_decimal const& a, big_decimal const& b);
+bool operator<=(big_decimal const& a, big_decimal const& b);
+bool operator>=(big_decimal const& a, big_decimal const& b);
+
+// All digits of the scale, "-0.050" for a mantissa of -50 at scale 3.
+std::string to_string(big_decimal const& a);
+std::ostream& operator<<(std::ostream& s, big_decimal const& a);
+
+#endif //BIGINT_BIG_DECIMAL_H
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <stdexcept>
+#include "big_divisor.h"
+#include "scratch_arena.h"
+
+namespace {
+big_integer const& nonzero(big_integer const& d) {
+	if (d == 0) {
+		throw std::runtime_error("Division by zero");
+	}
+	return d;
+}
+
+std::vector<uint32_t> shifted(std::vector<uint32_t> limbs, uint32_t shift) {
+	if (shift) {
+		limbs::lshift(limbs.data(), limbs.data(), limbs.size(), shift);
+	}
+	return limbs;
+}
+}
+
+big_divisor::big_divisor(big_integer const& d)
+	: value_(nonzero(d)),
+	  shift_(limbs::clz(value_.digits_.back())),
+	  normalized_(shifted({value_.digits_.cbegin(), value_.digits_.cbegin() + value_.digits_.size()}, shift_)),
+	  top_(normalized_.back()),
+	  top_two_(normalized_.back(), normalized_.size() > 1 ? normalized_[normalized_.size() - 2] : 0) {}
+
+void big_divisor::apply(big_integer const& a, big_integer* quotient, big_integer* remainder) const {
+	size_t an = a.digits_.size(), bn = normalized_.size();
+	if (an < bn || (an == bn && limbs::cmp_n(a.digits_.cbegin(), value_.digits_.cbegin(), an) < 0)) {
+		if (remainder) {
+			*remainder = a;
+		}
+		if (quotient) {
+			*quotient = big_integer();
+		}
+		return;
+	}
+#ifdef BIGINT_GMP
+	// mpn_tdiv_qr is subquadratic, which beats reusing the inverses below
+	// for anything but one-limb divisors.
+	if (bn > 1) {
+		big_integer::div_mod(a, value_, quotient, remainder);
+		return;
+	}
+#endif
+	bool quotient_sign = a.sign_ ^ value_.sign_;
+	bool remainder_sign = a.sign_;
+	scratch_frame frame;
+	uint32_t* u = frame.allocate(an + 1);
+	if (shift_) {
+		u[an] = limbs::lshift(u, a.digits_.cbegin(), an, shift_);
+	} else {
+		std::copy_n(a.digits_.cbegin(), an, u);
+		u[an] = 0;
+	}
+	if (bn == 1) {
+		// The quotient replaces the dividend, one limb longer than needed.
+		uint32_t rem = limbs::divrem_1(u, u, an + 1, top_);
+		if (quotient) {
+			quotient->assign_digits(u, an + 1, quotient_sign);
+		}
+		if (remainder) {
+			rem >>= shift_;
+			remainder->assign_digits(&rem, 1, remainder_sign);
+		}
+		return;
+	}
+	uint32_t* q = quotient ? frame.allocate(an - bn + 1) : nullptr;
+	limbs::divrem_normalized(q, u, an, normalized_.data(), bn, top_two_);
+	if (quotient) {
+		quotient->assign_digits(q, an - bn + 1, quotient_sign);
+	}
+	if (remainder) {
+		if (shift_) {
+			limbs::rshift(u, u, bn, shift_);
+		}
+		remainder->assign_digits(u, bn, remainder_sign);
+	}
+}
+
+big_integer divide(big_integer const& a, big_divisor const& d) {
+	big_integer result;
+	d.apply(a, &result, nullptr);
+	return result;
+}
+
+big_integer mod(big_integer const& a, big_divisor const& d) {
+	big_integer result;
+	d.apply(a, nullptr, &result);
+	return result;
+}
+
+void div_mod(big_integer const& a, big_divisor const& d, big_integer& quotient, big_integer& remainder) {
+	d.apply(a, &quotient, &remainder);
+}
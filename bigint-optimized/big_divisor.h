@@ -0,0 +1,42 @@
+#ifndef BIGINT_BIG_DIVISOR_H
+#define BIGINT_BIG_DIVISOR_H
+
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+#include "limb_kernels.h"
+
+// A divisor prepared once for dividing many values: its limbs are kept
+// shifted so that the top bit is set, along with the reciprocals of the top
+// limb and of the top two limbs. divide() and mod() then only shift the
+// dividend and run the division loop. They round like operator/ and
+// operator%, div_mod() gives both from a single pass.
+class big_divisor {
+public:
+	// Throws std::runtime_error for zero.
+	explicit big_divisor(big_integer const& d);
+
+	big_integer const& value() const {
+		return value_;
+	}
+
+private:
+	big_integer value_;
+	uint32_t shift_;
+	std::vector<uint32_t> normalized_;
+	// Only the reciprocal matching the length of the divisor is used.
+	limbs::divisor_1 top_;
+	limbs::divisor_2 top_two_;
+
+	void apply(big_integer const& a, big_integer* quotient, big_integer* remainder) const;
+
+	friend big_integer divide(big_integer const& a, big_divisor const& d);
+	friend big_integer mod(big_integer const& a, big_divisor const& d);
+	friend void div_mod(big_integer const& a, big_divisor const& d, big_integer& quotient, big_integer& remainder);
+};
+
+big_integer divide(big_integer const& a, big_divisor const& d);
+big_integer mod(big_integer const& a, big_divisor const& d);
+void div_mod(big_integer const& a, big_divisor const& d, big_integer& quotient, big_integer& remainder);
+
+#endif //BIGINT_BIG_DIVISOR_H
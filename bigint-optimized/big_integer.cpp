@@ -1,6 +1,13 @@
 #include "big_integer.h"
+#include "big_integer_view.h"
+#include "limb_dispatch.h"
+#include "limb_gmp.h"
+#include "limb_kernels.h"
+#include "limb_multiply.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
 
-using uint128_t = unsigned __int128;
+#include <stdexcept>
 
 #define _POSITIVE (false)
 #define _NEGATIVE (true)
@@ -14,16 +21,27 @@ void big_integer::normalize() {
 }
 
 void big_integer::resize_digits(size_t size) {
-	while (digits_.size() != size) {
-		digits_.push_back(0);
-	}
+	digits_.resize(size);
+}
+
+void big_integer::assign_digits(uint32_t const* src, size_t size, bool sign) {
+	digits_.reset(size);
+	std::copy_n(src, size, digits_.begin());
+	sign_ = sign;
+	normalize();
 }
 
-uint32_t get_digit(big_integer const& a, size_t ind, bool is_complement = false) {
-	if (is_complement)
-		return (ind < a.digits_.size() ? ~(a.digits_[ind]) + (ind == 0) : -1);
-	else
-		return (ind < a.digits_.size() ? a.digits_[ind] : 0);
+// r = 2^(32n) - a for a of an <= n limbs, the two's complement of -a in n
+// limbs. r may be a. Returns 1 when a is zero and the result would need
+// limb n.
+static uint32_t negate(uint32_t* r, uint32_t const* a, size_t an, size_t n) {
+	uint32_t carry = 1;
+	for (size_t i = 0; i < n; i++) {
+		uint32_t digit = ~(i < an ? a[i] : 0) + carry;
+		carry = carry && digit == 0;
+		r[i] = digit;
+	}
+	return carry;
 }
 
 big_integer abs(big_integer const& a) {
@@ -45,22 +63,39 @@ big_integer::big_integer(int a) {
 	}
 }
 
-big_integer::big_integer(uint32_t a) {
-	this->sign_ = _POSITIVE;
-	if (a != 0) {
-		this->digits_.push_back(a);
+void big_integer::assign_small(uint64_t magnitude, bool sign) {
+	digits_.reset(magnitude > UINT32_MAX ? 2 : magnitude != 0);
+	if (magnitude != 0) {
+		uint32_t* d = digits_.begin();
+		d[0] = static_cast<uint32_t>(magnitude);
+		if (magnitude > UINT32_MAX) {
+			d[1] = static_cast<uint32_t>(magnitude >> 32u);
+		}
 	}
+	sign_ = magnitude != 0 && sign;
 }
 
+uint64_t big_integer::low_u64() const {
+	uint64_t result = digits_.empty() ? 0 : digits_[0];
+	if (digits_.size() > 1) {
+		result |= static_cast<uint64_t>(digits_[1]) << 32u;
+	}
+	return result;
+}
+
+big_integer::big_integer(big_integer_view const& view)
+	: digits_(storage_t::borrow(view.limbs(), view.size())), sign_(view.negative()) {}
+
 big_integer::big_integer(std::string const& str) {
-	for (size_t i = (str[0] == '+' || str[0] == '-'); i < str.size(); i++) {
-		if (!isdigit(str[i])) {
-			throw std::runtime_error("Expected number, actual: " + str);
-		}
-		*this *= 10;
-		*this += (str[i] - '0');
+	char const* first = str.data() + (str[0] == '+' || str[0] == '-');
+	char const* last = str.data() + str.size();
+	if (!std::all_of(first, last, [](char c) { return c >= '0' && c <= '9'; })) {
+		throw std::runtime_error("Expected number, actual: " + str);
+	}
+	if (first != last) {
+		from_chars(first, last, *this);
 	}
-	this->sign_ = (*this != 0 && str[0] == '-' ? _NEGATIVE : _POSITIVE);
+	this->sign_ = (!digits_.empty() && str[0] == '-' ? _NEGATIVE : _POSITIVE);
 }
 
 big_integer operator+(big_integer a, big_integer const& b) {
@@ -83,39 +118,48 @@ big_integer operator%(big_integer a, big_integer const& b) {
 	return a %= b;
 }
 
-big_integer big_integer::to_complement(size_t size) {
-	resize_digits(size);
-	if (sign_ == _NEGATIVE) {
-		for (uint32_t& digit : digits_) {
-			digit = ~digit;
-		}
-		*this -= 1;
+// Works on n limbs of two's complement, where n limbs hold both magnitudes,
+// and keeps the sign apart as the value of every bit above them.
+big_integer bit_operation(big_integer a, big_integer const& b, uint32_t(*op)(uint32_t, uint32_t),
+                          void(*kernel)(uint32_t*, uint32_t const*, uint32_t const*, size_t)) {
+	size_t n = std::max(a.digits_.size(), b.digits_.size());
+	BIGINT_STATS_SCOPE(bitwise, n);
+	a.resize_digits(n);
+	uint32_t* d = a.digits_.begin();
+	if (a.sign_ == _NEGATIVE) {
+		negate(d, d, n, n);
 	}
-	return *this;
-}
-
-big_integer bit_operation(big_integer a, big_integer const& b, uint32_t(*op)(uint32_t, uint32_t)) {
-	size_t max_size = std::max(a.digits_.size(), b.digits_.size());
-	a.to_complement(max_size);
-	for (size_t i = 0; i < max_size; i++) {
-		a.digits_[i] = op(a.digits_[i], get_digit(b, i, b.sign_));
+	scratch_frame frame;
+	uint32_t const* other = b.digits_.cbegin();
+	size_t bn = b.digits_.size();
+	if (b.sign_ == _NEGATIVE || bn < n) {
+		uint32_t* extended = frame.allocate(n);
+		if (b.sign_ == _NEGATIVE) {
+			negate(extended, other, bn, n);
+		} else {
+			std::fill(std::copy_n(other, bn, extended), extended + n, 0);
+		}
+		other = extended;
 	}
+	kernel(d, d, other, n);
 	a.sign_ = op(a.sign_, b.sign_);
-	a.to_complement(max_size);
+	if (a.sign_ == _NEGATIVE && negate(d, d, n, n)) {
+		a.digits_.push_back(1);
+	}
 	a.normalize();
 	return a;
 }
 
 big_integer operator&(big_integer const& a, big_integer const& b) {
-	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x & y; });
+	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x & y; }, limbs::kernels().and_n);
 }
 
 big_integer operator|(big_integer const& a, big_integer const& b) {
-	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x | y; });
+	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x | y; }, limbs::kernels().or_n);
 }
 
 big_integer operator^(big_integer const& a, big_integer const& b) {
-	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x ^ y; });
+	return bit_operation(a, b, [](uint32_t x, uint32_t y) {return x ^ y; }, limbs::kernels().xor_n);
 }
 
 big_integer operator>>(big_integer a, int shift) {
@@ -164,37 +208,31 @@ big_integer big_integer::operator-() const {
 }
 
 void big_integer::sum(big_integer const& b) {
-	size_t max_size = std::max(digits_.size(), b.digits_.size());
+	size_t bn = b.digits_.size();
+	size_t max_size = std::max(digits_.size(), bn);
 	resize_digits(max_size);
-	uint64_t carry = 0;
-	for (size_t i = 0; i < max_size; i++) {
-		uint64_t tmp = static_cast<uint64_t>(digits_[i]) + static_cast<uint64_t>(get_digit(b, i)) + carry;
-		carry = tmp > static_cast<uint64_t>(UINT32_MAX);
-		digits_[i] = static_cast<uint32_t>(tmp);
-	}
+	uint32_t* d = digits_.begin();
+	uint32_t carry = limbs::kernels().add_n(d, d, b.digits_.cbegin(), bn);
+	carry = limbs::add_1(d + bn, d + bn, max_size - bn, carry);
 	if (carry)
 		digits_.push_back(carry);
 	normalize();
 }
 
+// Subtracts the smaller magnitude from the larger one; the result takes
+// the sign of *this, flipped if |b| was larger.
 void big_integer::subtract(big_integer const& b) {
-	bool a_sign = sign_;
-	sign_ = b.sign_;
-	bool less = (*this < b) ^ b.sign_;
-	sign_ = a_sign ^ less;
-	size_t max_size = std::max(digits_.size(), b.digits_.size());
-	resize_digits(max_size);
-	uint64_t carry = 0, tmp = 0;
-	for (size_t i = 0; i < max_size; i++) {
-		if (less) {
-			tmp = static_cast<uint64_t>(UINT32_MAX) + 1ull - carry +
-				static_cast<uint64_t>(get_digit(b, i)) - static_cast<uint64_t>(get_digit(*this, i));
-		} else {
-			tmp = static_cast<uint64_t>(UINT32_MAX) + 1ull - carry +
-				static_cast<uint64_t>(get_digit(*this, i)) - static_cast<uint64_t>(get_digit(b, i));
-		}
-		carry = tmp <= static_cast<uint64_t>(UINT32_MAX);
-		digits_[i] = static_cast<uint32_t>(tmp);
+	size_t an = digits_.size(), bn = b.digits_.size();
+	bool less = an != bn ? an < bn : limbs::cmp_n(digits_.cbegin(), b.digits_.cbegin(), an) < 0;
+	sign_ ^= less;
+	resize_digits(std::max(an, bn));
+	uint32_t* d = digits_.begin();
+	if (less) {
+		uint32_t borrow = limbs::kernels().sub_n(d, b.digits_.cbegin(), d, an);
+		limbs::sub_1(d + an, b.digits_.cbegin() + an, bn - an, borrow);
+	} else {
+		uint32_t borrow = limbs::kernels().sub_n(d, d, b.digits_.cbegin(), bn);
+		limbs::sub_1(d + bn, d + bn, an - bn, borrow);
 	}
 	normalize();
 }
@@ -207,123 +245,252 @@ void big_integer::additive_operation(big_integer const& b, bool is_subtract) {
 	}
 }
 
+// Either both values fit in a uint64_t, or |*this| >= 2^64 > magnitude
+// keeps its sign and the carry or borrow stops after a few limbs.
+void big_integer::add_small(uint64_t magnitude, bool negative) {
+	if (magnitude == 0) {
+		return;
+	}
+	size_t n = digits_.size();
+	if (n <= 2) {
+		uint64_t cur = low_u64();
+		if (sign_ == negative) {
+			uint64_t sum = cur + magnitude;
+			if (sum >= cur) {
+				assign_small(sum, sign_);
+			} else {
+				uint32_t const result[3] = {static_cast<uint32_t>(sum), static_cast<uint32_t>(sum >> 32u), 1};
+				assign_digits(result, 3, sign_);
+			}
+		} else if (cur >= magnitude) {
+			assign_small(cur - magnitude, sign_);
+		} else {
+			assign_small(magnitude - cur, negative);
+		}
+		return;
+	}
+	uint32_t const b[2] = {static_cast<uint32_t>(magnitude), static_cast<uint32_t>(magnitude >> 32u)};
+	uint32_t* d = digits_.begin();
+	if (sign_ == negative) {
+		uint32_t carry = limbs::add_n(d, d, b, 2);
+		for (size_t i = 2; carry && i < n; i++) {
+			carry = ++d[i] == 0;
+		}
+		if (carry) {
+			digits_.push_back(carry);
+		}
+	} else {
+		uint32_t borrow = limbs::sub_n(d, d, b, 2);
+		for (size_t i = 2; borrow && i < n; i++) {
+			borrow = d[i]-- == 0;
+		}
+		normalize();
+	}
+}
+
 big_integer& big_integer::operator+=(big_integer const& b) {
-	additive_operation(b, false);
+	BIGINT_STATS_SCOPE(add, std::max(digits_.size(), b.digits_.size()));
+	if (b.digits_.size() <= 2) {
+		add_small(b.low_u64(), b.sign_);
+	} else {
+		additive_operation(b, false);
+	}
 	return *this;
 }
 
 big_integer& big_integer::operator-=(big_integer const& b) {
-	additive_operation(b, true);
+	BIGINT_STATS_SCOPE(sub, std::max(digits_.size(), b.digits_.size()));
+	if (b.digits_.size() <= 2) {
+		add_small(b.low_u64(), !b.sign_);
+	} else {
+		additive_operation(b, true);
+	}
 	return *this;
 }
 
-big_integer& big_integer::operator*=(big_integer const& b) {
-	big_integer result;
-	result.resize_digits(digits_.size() + b.digits_.size() + 1);
-	result.sign_ = (sign_ ^ b.sign_ ? _NEGATIVE : _POSITIVE);
-	for (size_t i = 0; i < digits_.size(); i++) {
-		uint32_t carry = 0;
-		for (size_t j = 0; j < b.digits_.size(); j++) {
-			uint64_t mul = static_cast<uint64_t>(digits_[i]) * b.digits_[j] + result.digits_[i + j] + carry;
-			result.digits_[i + j] = static_cast<uint32_t>(mul);
-			carry = static_cast<uint32_t>(mul >> static_cast<uint64_t>(32));
+void big_integer::mul_small(uint64_t magnitude, bool negative) {
+	if (digits_.empty() || magnitude == 0) {
+		assign_small(0, _POSITIVE);
+		return;
+	}
+	bool sign = sign_ ^ negative;
+	size_t n = digits_.size();
+	if (magnitude <= UINT32_MAX) {
+		uint32_t* d = digits_.begin();
+		uint32_t carry = limbs::mul_1(d, d, n, static_cast<uint32_t>(magnitude));
+		if (carry) {
+			digits_.push_back(carry);
 		}
-		result.digits_[i + b.digits_.size()] += carry;
+		sign_ = sign;
+		return;
 	}
-	result.normalize();
-	return *this = result;
+	uint32_t const b[2] = {static_cast<uint32_t>(magnitude), static_cast<uint32_t>(magnitude >> 32u)};
+	if (n <= 2) {
+		uint32_t result[4];
+		limbs::mul_basecase(result, b, 2, digits_.cbegin(), n);
+		assign_digits(result, n + 2, sign);
+		return;
+	}
+	scratch_frame frame;
+	uint32_t* result = frame.allocate(n + 2);
+	limbs::mul_basecase(result, digits_.cbegin(), n, b, 2);
+	assign_digits(result, n + 2, sign);
 }
 
-uint32_t count_lz(uint32_t x) {
-	for (uint32_t i = 31; i > 0; i--) {
-		if (x & (1u << i))
-			return 31u - i;
+big_integer& big_integer::operator*=(big_integer const& b) {
+	BIGINT_STATS_SCOPE(mul, std::max(digits_.size(), b.digits_.size()));
+	if (b.digits_.size() <= 2) {
+		mul_small(b.low_u64(), b.sign_);
+		return *this;
+	}
+	bool sign = sign_ ^ b.sign_;
+	if (digits_.empty() || b.digits_.empty()) {
+		return *this = big_integer();
+	}
+	scratch_frame frame;
+	size_t an = digits_.size(), bn = b.digits_.size();
+	uint32_t* result = frame.allocate(an + bn);
+	if (an >= bn) {
+		limbs::mul(result, digits_.cbegin(), an, b.digits_.cbegin(), bn, get_thread_limit());
+	} else {
+		limbs::mul(result, b.digits_.cbegin(), bn, digits_.cbegin(), an, get_thread_limit());
 	}
-	return 31;
+	assign_digits(result, an + bn, sign);
+	return *this;
 }
 
-big_integer div_long_short(big_integer const& a, uint32_t b) {
-	big_integer result;
-	uint64_t tmp = 0;
-	for (size_t i = a.digits_.size(); i > 0; i--) {
-		tmp = (tmp << static_cast<uint64_t>(32)) + a.digits_[i - 1];
-		result.digits_.push_back(tmp / static_cast<uint64_t>(b));
-		tmp = tmp % b;
+namespace {
+// Knuth's algorithm D. Writes an - bn + 1 limbs of |a| / |b| to quotient and
+// bn limbs of |a| % |b| to remainder, either of which may be null.
+// Requires an >= bn and a nonzero top limb of b.
+void divide_limbs(uint32_t* quotient, uint32_t* remainder,
+                  uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	scratch_frame frame;
+	if (bn == 1) {
+		uint32_t* q = quotient ? quotient : frame.allocate(an);
+		uint32_t rem = limbs::divrem_1(q, a, an, b[0]);
+		if (remainder) {
+			remainder[0] = rem;
+		}
+		return;
 	}
-	std::reverse(result.digits_.begin(), result.digits_.end());
-	result.normalize();
-	return result;
+#ifdef BIGINT_GMP
+	limbs::gmp_divrem(quotient, remainder, a, an, b, bn);
+#else
+	uint32_t shift = limbs::clz(b[bn - 1]);
+	uint32_t* v = frame.allocate(bn);
+	uint32_t* u = frame.allocate(an + 1);
+	if (shift) {
+		limbs::lshift(v, b, bn, shift);
+		u[an] = limbs::lshift(u, a, an, shift);
+	} else {
+		std::copy_n(b, bn, v);
+		std::copy_n(a, an, u);
+		u[an] = 0;
+	}
+	limbs::divrem_normalized(quotient, u, an, v, bn);
+	if (remainder) {
+		if (shift) {
+			limbs::rshift(remainder, u, bn, shift);
+		} else {
+			std::copy_n(u, bn, remainder);
+		}
+	}
+#endif
 }
-
-uint32_t trial(big_integer const& a, big_integer const& b) {
-	uint128_t x = (static_cast<uint128_t>(a.digits_[a.digits_.size() - 1]) << 64u) |
-		(static_cast<uint128_t>(a.digits_[a.digits_.size() - 2]) << 32u) |
-		(static_cast<uint128_t>(a.digits_[a.digits_.size() - 3]));
-	uint128_t y = ((static_cast<uint128_t>(b.digits_[b.digits_.size() - 1]) << 32u) |
-		(static_cast<uint128_t>(b.digits_[b.digits_.size() - 2])));
-	return static_cast<uint32_t>(std::min(static_cast<uint128_t>(UINT32_MAX), x / y));
 }
 
-void difference(big_integer& a, big_integer const& b, size_t ind) {
-	size_t start = a.digits_.size() - ind;
-	uint32_t c = 0;
-	for (size_t i = 0; i < ind; i++) {
-		uint32_t cur = a.digits_[start + i];
-		a.digits_[start + i] = static_cast<uint32_t>(static_cast<uint64_t>(cur) - get_digit(b, i) - c);
-		c = get_digit(b, i) + c > cur;
+void big_integer::div_mod(big_integer const& a, big_integer const& b, big_integer* quotient, big_integer* remainder) {
+	if (b.digits_.empty()) {
+		throw std::runtime_error("Division by zero");
+	}
+	size_t an = a.digits_.size(), bn = b.digits_.size();
+	if (an < bn || (an == bn && limbs::cmp_n(a.digits_.cbegin(), b.digits_.cbegin(), an) < 0)) {
+		if (remainder) {
+			*remainder = a;
+		}
+		if (quotient) {
+			*quotient = big_integer();
+		}
+		return;
+	}
+	bool quotient_sign = a.sign_ ^ b.sign_;
+	bool remainder_sign = a.sign_;
+	scratch_frame frame;
+	uint32_t* q = quotient ? frame.allocate(an - bn + 1) : nullptr;
+	uint32_t* r = remainder ? frame.allocate(bn) : nullptr;
+	divide_limbs(q, r, a.digits_.cbegin(), an, b.digits_.cbegin(), bn);
+	if (quotient) {
+		quotient->assign_digits(q, an - bn + 1, quotient_sign);
+	}
+	if (remainder) {
+		remainder->assign_digits(r, bn, remainder_sign);
 	}
 }
 
-bool less(big_integer const& a, big_integer const& b, size_t ind) {
-	for (size_t i = 1; i <= a.digits_.size(); i++) {
-		if (a.digits_[a.digits_.size() - i] != get_digit(b, ind - i)) {
-			return a.digits_[a.digits_.size() - i] < get_digit(b, ind - i);
+// Returns |*this| % divisor and, if asked to, replaces the magnitude of
+// *this with the quotient.
+uint64_t big_integer::divide_small(uint64_t divisor, bool keep_quotient) {
+	if (divisor == 0) {
+		throw std::runtime_error("Division by zero");
+	}
+	size_t n = digits_.size();
+	if (n <= 2) {
+		uint64_t cur = low_u64();
+		if (keep_quotient) {
+			assign_small(cur / divisor, sign_);
 		}
+		return cur % divisor;
 	}
-	return false;
+	if (divisor <= UINT32_MAX) {
+		if (keep_quotient) {
+			uint32_t* d = digits_.begin();
+			uint32_t rem = limbs::divrem_1(d, d, n, static_cast<uint32_t>(divisor));
+			normalize();
+			return rem;
+		}
+		return limbs::mod_1(digits_.cbegin(), n, static_cast<uint32_t>(divisor));
+	}
+	uint32_t const b[2] = {static_cast<uint32_t>(divisor), static_cast<uint32_t>(divisor >> 32u)};
+	uint32_t rem[2];
+	scratch_frame frame;
+	uint32_t* q = keep_quotient ? frame.allocate(n - 1) : nullptr;
+	divide_limbs(q, rem, digits_.cbegin(), n, b, 2);
+	if (keep_quotient) {
+		assign_digits(q, n - 1, sign_);
+	}
+	return rem[0] | (static_cast<uint64_t>(rem[1]) << 32u);
 }
 
-big_integer& big_integer::operator/=(big_integer const& _b) {
-	big_integer ans;
-	bool sign = sign_ ^ _b.sign_;
-	big_integer b(abs(_b));
-	sign_ = _POSITIVE;
-	if (*this < b) {
-		return *this = big_integer(0);
+void big_integer::div_small(uint64_t magnitude, bool negative) {
+	bool sign = sign_ ^ negative;
+	divide_small(magnitude, true);
+	if (!digits_.empty()) {
+		sign_ = sign;
 	}
-	if (b.digits_.size() == 1) {
-		ans = div_long_short(*this, b.digits_.back());
+}
+
+void big_integer::mod_small(uint64_t magnitude) {
+	assign_small(divide_small(magnitude, false), sign_);
+}
+
+big_integer& big_integer::operator/=(big_integer const& b) {
+	BIGINT_STATS_SCOPE(div, std::max(digits_.size(), b.digits_.size()));
+	if (b.digits_.size() <= 2) {
+		div_small(b.low_u64(), b.sign_);
 	} else {
-		uint32_t shift = count_lz(b.digits_.back());
-		*this <<= shift;
-		b <<= shift;
-		digits_.push_back(0);
-		size_t n = digits_.size();
-		size_t m = b.digits_.size() + 1;
-		size_t k = n - m;
-		ans.resize_digits(k + 1);
-		for (size_t i = k + 1; i > 0; i--) {
-			uint32_t qt = trial(*this, b);
-			big_integer ml = b * qt;
-			if (less(*this, ml, m)) {
-				qt--;
-				ml -= b;
-			}
-			ans.digits_[i - 1] = qt;
-			difference(*this, ml, m);
-			if (!digits_.back()) {
-				digits_.pop_back();
-			}
-		}
-		b >>= shift;
+		div_mod(*this, b, this, nullptr);
 	}
-	ans.sign_ = sign;
-	ans.normalize();
-	return *this = ans;
+	return *this;
 }
 
 big_integer& big_integer::operator%=(big_integer const& b) {
-	*this = *this - (*this / b) * b;
+	BIGINT_STATS_SCOPE(mod, std::max(digits_.size(), b.digits_.size()));
+	if (b.digits_.size() <= 2) {
+		mod_small(b.low_u64());
+	} else {
+		div_mod(*this, b, nullptr, this);
+	}
 	return *this;
 }
 
@@ -343,19 +510,77 @@ big_integer& big_integer::operator^=(big_integer const& other) {
 }
 
 big_integer& big_integer::operator>>=(int shift) {
-	*this /= (1u << (shift % 32u));
-	size_t new_shift = std::min(static_cast<size_t>(shift / 32), digits_.size());
-	for (size_t i = 0; i < digits_.size() - new_shift; i++) {
-		digits_[i] = digits_[i + new_shift];
+	BIGINT_STATS_SCOPE(shift, digits_.size());
+	size_t n = digits_.size(), words = static_cast<size_t>(shift) / 32;
+	bool negative = sign_;
+	if (words >= n) {
+		assign_small(negative, negative);
+		return *this;
+	}
+	// Rounds toward minus infinity: a negative value whose shifted-out bits
+	// are not all zero moves one further away from zero.
+	uint32_t* d = digits_.begin();
+	bool inexact = false;
+	for (size_t i = 0; negative && !inexact && i < words; i++) {
+		inexact = d[i] != 0;
 	}
-	digits_.erase(digits_.begin() + digits_.size() - new_shift, digits_.begin() + digits_.size());
-	return *this -= sign_ == _NEGATIVE;
+	std::copy(d + words, d + n, d);
+	if (shift % 32 != 0) {
+		inexact |= limbs::rshift(d, d, n - words, static_cast<uint32_t>(shift) % 32u) != 0;
+	}
+	digits_.resize(n - words);
+	normalize();
+	if (negative && inexact) {
+		sign_ = _NEGATIVE;
+		add_small(1, _NEGATIVE);
+	}
+	return *this;
 }
 
 big_integer& big_integer::operator<<=(int shift) {
+	BIGINT_STATS_SCOPE(shift, digits_.size());
 	*this *= (1u << (shift % 32u));
 	size_t new_shift = shift / 32;
-	digits_.insert(digits_.begin(), new_shift, 0);
+	if (!digits_.empty()) {
+		digits_.insert(digits_.begin(), new_shift, 0);
+	}
+	return *this;
+}
+
+size_t big_integer::bit_length() const {
+	return limbs::bit_length(digits_.cbegin(), digits_.size());
+}
+
+size_t big_integer::popcount() const {
+	return limbs::kernels().popcount(digits_.cbegin(), digits_.size());
+}
+
+size_t big_integer::ctz() const {
+	for (size_t i = 0; i < digits_.size(); i++) {
+		if (digits_[i] != 0) {
+			return 32 * i + limbs::ctz(digits_[i]);
+		}
+	}
+	return 0;
+}
+
+bool big_integer::test_bit(size_t i) const {
+	return i / 32 < digits_.size() && ((digits_[i / 32] >> (i % 32)) & 1u);
+}
+
+big_integer& big_integer::set_bit(size_t i) {
+	if (i / 32 >= digits_.size()) {
+		resize_digits(i / 32 + 1);
+	}
+	digits_[i / 32] |= 1u << (i % 32);
+	return *this;
+}
+
+big_integer& big_integer::clear_bit(size_t i) {
+	if (i / 32 < digits_.size()) {
+		digits_[i / 32] &= ~(1u << (i % 32));
+		normalize();
+	}
 	return *this;
 }
 
@@ -377,6 +602,15 @@ bool operator>(big_integer const& a, big_integer const& b) {
 	return b < a;
 }
 
+int big_integer::compare_small(uint64_t magnitude, bool negative) const {
+	if (sign_ != negative) {
+		return sign_ == _NEGATIVE ? -1 : 1;
+	}
+	uint64_t cur = low_u64();
+	int result = digits_.size() > 2 ? 1 : (cur > magnitude) - (cur < magnitude);
+	return sign_ == _NEGATIVE ? -result : result;
+}
+
 bool operator==(big_integer const& a, big_integer const& b) {
 	return !(a < b) && !(a > b);
 }
@@ -393,20 +627,25 @@ bool operator>=(big_integer const& a, big_integer const& b) {
 	return !(a < b);
 }
 
-std::string to_string(big_integer x) {
-	bool sign = x.sign_;
-	x = abs(x);
-	std::string result;
-	while (x != 0) {
-		big_integer rem = x % 10;
-		result.push_back('0' + (rem.digits_.empty() ? 0 : rem.digits_[0]));
-		x /= 10;
-	}
-	if (sign) {
-		result.push_back('-');
+namespace {
+uint64_t with_sign(uint64_t magnitude_hash, bool sign) {
+	return limbs::mix(magnitude_hash + (sign == _NEGATIVE ? 0x9E3779B97F4A7C15ull : 0));
+}
+}
+
+uint64_t hash_value(big_integer const& a, uint64_t seed) {
+	return with_sign(limbs::hash(a.digits_.cbegin(), a.digits_.size(), seed), a.sign_);
+}
+
+// Zero marks an empty cache slot, so a magnitude hashing to zero is simply
+// recomputed every time.
+uint64_t hash_value(big_integer const& a) {
+	uint64_t h = a.digits_.cached_hash();
+	if (h == 0) {
+		h = limbs::hash(a.digits_.cbegin(), a.digits_.size(), 0);
+		a.digits_.cache_hash(h);
 	}
-	std::reverse(result.begin(), result.end());
-	return (result.empty() ? "0" : result);
+	return with_sign(h, a.sign_);
 }
 
 #undef _POSITIVE
@@ -5,38 +5,89 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <charconv>
 #include <functional>
+#include <iosfwd>
+#include <type_traits>
+#include "big_integer_stats.h"
 #include "optimized_vector.h"
 
+struct byte_span;
+class big_integer_view;
+template<size_t Bits, bool Signed>
+class wide_integer;
+
 struct big_integer {
 private:
 	using storage_t = optimized_vector;
 	storage_t digits_;
 	bool sign_ = false;
 
-	big_integer(uint32_t a);
 	void resize_digits(size_t size);
 	void normalize();
 	friend big_integer abs(big_integer const&);
 	friend void swap(big_integer&, big_integer&);
-	friend big_integer div_long_short(big_integer const&, uint32_t);
-	friend uint32_t trial(big_integer const&, big_integer const&);
-	friend uint32_t get_digit(big_integer const&, size_t, bool);
-	friend bool less(big_integer const&, big_integer const&, size_t);
-	friend void difference(big_integer&, big_integer const&, size_t);
-	friend big_integer bit_operation(big_integer, big_integer const&, uint32_t(*op)(uint32_t, uint32_t));
-	friend uint32_t count_lz(uint32_t);
-	big_integer to_complement(size_t size);
+	friend big_integer bit_operation(big_integer, big_integer const&, uint32_t(*op)(uint32_t, uint32_t),
+	                                 void(*kernel)(uint32_t*, uint32_t const*, uint32_t const*, size_t));
+	friend struct radix_conversion;
+	friend struct prime_testing;
+	friend struct lehmer_gcd;
+	friend class limb_batch;
+	friend class big_divisor;
+	template<size_t Bits, bool Signed>
+	friend class wide_integer;
 	void sum(big_integer const&);
 	void subtract(big_integer const&);
 	void additive_operation(big_integer const&, bool);
+	void assign_digits(uint32_t const* src, size_t size, bool sign);
+	static void div_mod(big_integer const& a, big_integer const& b, big_integer* quotient, big_integer* remainder);
+
+	// Fast paths for operands of at most 64 bits, given as magnitude and
+	// sign. Values of up to two limbs are worked on as a single uint64_t.
+	template<typename T>
+	using if_integral = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>;
+
+	template<typename T>
+	static bool is_negative(T value) {
+		return std::is_signed<T>::value && value < 0;
+	}
+
+	template<typename T>
+	static uint64_t magnitude(T value) {
+		return is_negative(value) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+	}
+
+	uint64_t low_u64() const;
+	void assign_small(uint64_t magnitude, bool sign);
+	void add_small(uint64_t magnitude, bool negative);
+	void mul_small(uint64_t magnitude, bool negative);
+	uint64_t divide_small(uint64_t divisor, bool keep_quotient);
+	void div_small(uint64_t magnitude, bool negative);
+	void mod_small(uint64_t magnitude);
+	int compare_small(uint64_t magnitude, bool negative) const;
 public:
 	big_integer() = default;
 	big_integer(big_integer const& a) = default;
+	big_integer(big_integer&& a) noexcept : digits_(std::move(a.digits_)), sign_(a.sign_) {
+		a.sign_ = false;
+	}
 	big_integer(int a);
+	template<typename T, if_integral<T> = 0>
+	big_integer(T a) {
+		assign_small(magnitude(a), is_negative(a));
+	}
 	explicit big_integer(std::string const& str);
+	big_integer(big_integer_view const& view);
 
 	big_integer& operator=(big_integer const& other) = default;
+	big_integer& operator=(big_integer&& other) noexcept {
+		if (&other != this) {
+			digits_ = std::move(other.digits_);
+			sign_ = other.sign_;
+			other.sign_ = false;
+		}
+		return *this;
+	}
 
 	friend big_integer operator+(big_integer a, big_integer const& b);
 	friend big_integer operator-(big_integer a, big_integer const& b);
@@ -72,6 +123,151 @@ public:
 	big_integer& operator<<=(int rhs);
 	big_integer& operator>>=(int rhs);
 
+	// Bit queries on the magnitude; the sign is neither read nor changed.
+	// bit_length() and ctz() are zero for zero.
+	size_t bit_length() const;
+	size_t popcount() const;
+	size_t ctz() const;
+	bool test_bit(size_t i) const;
+	big_integer& set_bit(size_t i);
+	big_integer& clear_bit(size_t i);
+
+	template<typename T, if_integral<T> = 0>
+	big_integer& operator+=(T rhs) {
+		BIGINT_STATS_SCOPE(add, digits_.size());
+		add_small(magnitude(rhs), is_negative(rhs));
+		return *this;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	big_integer& operator-=(T rhs) {
+		BIGINT_STATS_SCOPE(sub, digits_.size());
+		add_small(magnitude(rhs), !is_negative(rhs));
+		return *this;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	big_integer& operator*=(T rhs) {
+		BIGINT_STATS_SCOPE(mul, digits_.size());
+		mul_small(magnitude(rhs), is_negative(rhs));
+		return *this;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	big_integer& operator/=(T rhs) {
+		BIGINT_STATS_SCOPE(div, digits_.size());
+		div_small(magnitude(rhs), is_negative(rhs));
+		return *this;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	big_integer& operator%=(T rhs) {
+		BIGINT_STATS_SCOPE(mod, digits_.size());
+		mod_small(magnitude(rhs));
+		return *this;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator+(big_integer a, T b) {
+		return a += b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator+(T a, big_integer b) {
+		return b += a;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator-(big_integer a, T b) {
+		return a -= b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator-(T a, big_integer b) {
+		b -= a;
+		return -b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator*(big_integer a, T b) {
+		return a *= b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator*(T a, big_integer b) {
+		return b *= a;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator/(big_integer a, T b) {
+		return a /= b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend big_integer operator%(big_integer a, T b) {
+		return a %= b;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator==(big_integer const& a, T b) {
+		return a.compare_small(magnitude(b), is_negative(b)) == 0;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator==(T a, big_integer const& b) {
+		return b == a;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator!=(big_integer const& a, T b) {
+		return !(a == b);
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator!=(T a, big_integer const& b) {
+		return !(b == a);
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator<(big_integer const& a, T b) {
+		return a.compare_small(magnitude(b), is_negative(b)) < 0;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator<(T a, big_integer const& b) {
+		return b.compare_small(magnitude(a), is_negative(a)) > 0;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator>(big_integer const& a, T b) {
+		return b < a;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator>(T a, big_integer const& b) {
+		return b < a;
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator<=(big_integer const& a, T b) {
+		return !(b < a);
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator<=(T a, big_integer const& b) {
+		return !(b < a);
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator>=(big_integer const& a, T b) {
+		return !(a < b);
+	}
+
+	template<typename T, if_integral<T> = 0>
+	friend bool operator>=(T a, big_integer const& b) {
+		return !(a < b);
+	}
+
 	friend bool operator==(big_integer const&, big_integer const&);
 	friend bool operator!=(big_integer const&, big_integer const&);
 	friend bool operator<(big_integer const&, big_integer const&);
@@ -79,6 +275,50 @@ public:
 	friend bool operator<=(big_integer const&, big_integer const&);
 	friend bool operator>=(big_integer const&, big_integer const&);
 
-	friend std::string to_string(big_integer a);
+	friend std::string to_string(big_integer const& a);
+
+	friend uint64_t hash_value(big_integer const& a, uint64_t seed);
+	friend uint64_t hash_value(big_integer const& a);
+
+	friend size_t serialized_size(big_integer const& a);
+	friend size_t serialize(big_integer const& a, uint8_t* out);
+	friend size_t deserialize(byte_span in, big_integer& out);
+};
+
+// Conversions in bases 2 to 36 with lowercase digits and no prefix; other
+// bases throw. to_chars and from_chars follow their std counterparts: a
+// leading '-' only, value_too_large leaves the buffer in an unspecified
+// state, invalid_argument leaves the value untouched.
+std::string to_string(big_integer const& a, int base);
+big_integer from_string(std::string const& str, int base = 10);
+std::to_chars_result to_chars(char* first, char* last, big_integer const& value, int base = 10);
+std::from_chars_result from_chars(char const* first, char const* last, big_integer& value, int base = 10);
+
+// Stream digits through the stream buffer without building a string. Both
+// follow the basefield of the stream; output also honors showbase, showpos,
+// uppercase and the field width. Input without a basefield detects the
+// base from a 0 or 0x prefix.
+std::ostream& operator<<(std::ostream& s, big_integer const& a);
+std::istream& operator>>(std::istream& s, big_integer& a);
+
+// Product of the values in [first, last), one for an empty range. The
+// values are multiplied along a balanced tree, so both operands of each
+// multiplication have about as many factors. With a thread limit above 1
+// independent subtrees run in parallel.
+big_integer product(big_integer const* first, big_integer const* last);
+
+template<typename It>
+big_integer product(It first, It last) {
+	std::vector<big_integer> const values(first, last);
+	return product(values.data(), values.data() + values.size());
+}
+
+namespace std {
+template<>
+struct hash<big_integer> {
+	size_t operator()(big_integer const& a) const {
+		return static_cast<size_t>(hash_value(a));
+	}
 };
+}
 #endif // BIG_INTEGER_H
\ No newline at end of file
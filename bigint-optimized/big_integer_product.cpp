@@ -0,0 +1,44 @@
+#include "big_integer.h"
+#include "thread_pool.h"
+
+namespace {
+// Subtrees with fewer factors are cheaper than handing them to a worker.
+size_t const PARALLEL_FACTORS = 64;
+
+// Leaves are multiplied in pairs; a pair of one-limb factors stays in the
+// small buffer.
+big_integer product_tree(big_integer const* first, size_t n, size_t threads) {
+	if (n == 1) {
+		return *first;
+	}
+	if (n == 2) {
+		return first[0] * first[1];
+	}
+	size_t half = n / 2;
+	big_integer left, right;
+	if (threads > 1 && n >= PARALLEL_FACTORS) {
+		size_t budget = (threads + 1) / 2;
+		task_group group(thread_pool::global());
+		group.run([&left, first, half, budget] {
+			scoped_thread_limit limit(budget);
+			left = product_tree(first, half, budget);
+		});
+		right = product_tree(first + half, n - half, budget);
+		group.wait();
+	} else {
+		left = product_tree(first, half, 1);
+		right = product_tree(first + half, n - half, 1);
+	}
+	return left *= right;
+}
+}
+
+// Multiplications run under the thread limit of the thread doing them, so
+// the few large products at the top of the tree, or of a short range of
+// huge factors, fork their Karatsuba branches instead.
+big_integer product(big_integer const* first, big_integer const* last) {
+	if (first == last) {
+		return 1;
+	}
+	return product_tree(first, static_cast<size_t>(last - first), get_thread_limit());
+}
@@ -0,0 +1,472 @@
+#include "big_integer.h"
+#include "limb_kernels.h"
+#include "scratch_arena.h"
+
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#define _POSITIVE (false)
+#define _NEGATIVE (true)
+
+// Text conversions in bases 2 to 36. Power-of-two bases are packed and
+// unpacked bit by bit in linear time. Other bases go through chunks of as
+// many digits as fit in a limb; above a threshold the number is split in
+// halves by a cached power base^(2^k * chunk_digits) and the halves are
+// converted recursively, which trades the quadratic number of limb
+// divisions for a few big multiplications and divisions.
+struct radix_conversion {
+	// Numbers of at least this many limbs are printed by splitting.
+	static constexpr size_t TO_CHARS_SPLIT_LIMBS = 32;
+	// Strings of at least this many chunks are parsed by splitting.
+	static constexpr size_t FROM_CHARS_SPLIT_CHUNKS = 64;
+
+	static constexpr char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+	static void check_base(int base) {
+		if (base < 2 || base > 36) {
+			throw std::runtime_error("Unsupported base: " + std::to_string(base));
+		}
+	}
+
+	// Bits per digit for power-of-two bases, zero for the rest.
+	static uint32_t bits_per_digit(int base) {
+		return (base & (base - 1)) == 0 ? static_cast<uint32_t>(__builtin_ctz(base)) : 0;
+	}
+
+	static uint32_t digit_value(char c) {
+		if (c >= '0' && c <= '9') {
+			return static_cast<uint32_t>(c - '0');
+		}
+		if (c >= 'a' && c <= 'z') {
+			return static_cast<uint32_t>(c - 'a' + 10);
+		}
+		if (c >= 'A' && c <= 'Z') {
+			return static_cast<uint32_t>(c - 'A' + 10);
+		}
+		return 36;
+	}
+
+	// Largest power of the base that fits in a limb.
+	static uint32_t chunk_digits(int base) {
+		uint32_t digits = 0;
+		for (uint64_t p = base; p <= UINT32_MAX; p *= base) {
+			digits++;
+		}
+		return digits;
+	}
+
+	static uint32_t power(int base, size_t exponent) {
+		uint32_t result = 1;
+		for (size_t i = 0; i < exponent; i++) {
+			result *= static_cast<uint32_t>(base);
+		}
+		return result;
+	}
+
+	// base^(2^k * chunk_digits). The table is per thread and lives in the
+	// default resource, not in whatever scoped resource the caller runs on.
+	static big_integer const& split_power(int base, size_t k) {
+		static thread_local std::vector<big_integer> powers[37];
+		std::vector<big_integer>& table = powers[base];
+		if (table.size() <= k) {
+			scoped_limb_resource default_resource(nullptr);
+			if (table.empty()) {
+				table.push_back(big_integer(power(base, chunk_digits(base))));
+			}
+			while (table.size() <= k) {
+				table.push_back(table.back() * table.back());
+			}
+		}
+		return table[k];
+	}
+
+	// Upper bound on the length of to_string(a, base).
+	static size_t max_chars(big_integer const& a, int base) {
+		return 1 + max_digits(std::max<size_t>(a.digits_.size(), 1), base);
+	}
+
+	// Upper bound on the number of digits of an n-limb magnitude.
+	static size_t max_digits(size_t n, int base) {
+		uint32_t bits = bits_per_digit(base);
+		if (bits) {
+			return (n * 32 + bits - 1) / bits;
+		}
+		return static_cast<size_t>(std::ceil(n * 32 / std::log2(base))) + 1;
+	}
+
+	// Writes all digits of a nonzero magnitude, most significant first.
+	static char* write_pow2(char* out, uint32_t const* a, size_t n, uint32_t bits) {
+		uint32_t const mask = (1u << bits) - 1;
+		size_t count = (limbs::bit_length(a, n) + bits - 1) / bits;
+		for (size_t i = count; i > 0; i--) {
+			size_t pos = (i - 1) * bits;
+			size_t limb = pos / 32;
+			uint32_t offset = pos % 32;
+			uint32_t v = a[limb] >> offset;
+			if (offset + bits > 32 && limb + 1 < n) {
+				v |= a[limb + 1] << (32 - offset);
+			}
+			*out++ = DIGITS[v & mask];
+		}
+		return out;
+	}
+
+	// Writes exactly width digits of a magnitude below base^width, padding
+	// with zeros on the left. Destroys x.
+	static void write_chunks(char* out, size_t width, uint32_t* x, size_t n, int base) {
+		uint32_t const digits = chunk_digits(base);
+		limbs::divisor_1 const chunk_base(power(base, digits));
+		char* pos = out + width;
+		while (n > 0) {
+			uint32_t v = limbs::divrem_1(x, x, n, chunk_base);
+			n = limbs::normalized_size(x, n);
+			for (uint32_t k = 0; k < digits && pos != out; k++) {
+				*--pos = DIGITS[v % base];
+				v /= base;
+			}
+		}
+		std::fill(out, pos, '0');
+	}
+
+	static void write_split(char* out, size_t width, big_integer const& x, int base) {
+		size_t n = x.digits_.size();
+		if (n < TO_CHARS_SPLIT_LIMBS) {
+			scratch_frame frame;
+			uint32_t* copy = frame.allocate(n);
+			std::copy_n(x.digits_.cbegin(), n, copy);
+			write_chunks(out, width, copy, n, base);
+			return;
+		}
+		size_t k = 0;
+		while (split_power(base, k + 1).digits_.size() * 2 <= n) {
+			k++;
+		}
+		size_t low_width = static_cast<size_t>(chunk_digits(base)) << k;
+		big_integer high, low;
+		big_integer::div_mod(x, split_power(base, k), &high, &low);
+		write_split(out, width - low_width, high, base);
+		write_split(out + width - low_width, low_width, low, base);
+	}
+
+	// Writes the digits of |value| without a sign.
+	static std::to_chars_result write_magnitude(char* first, char* last, big_integer const& value, int base) {
+		size_t n = value.digits_.size();
+		if (n == 0) {
+			if (first == last) {
+				return {last, std::errc::value_too_large};
+			}
+			*first = '0';
+			return {first + 1, std::errc()};
+		}
+		uint32_t bits = bits_per_digit(base);
+		if (bits) {
+			size_t count = (value.bit_length() + bits - 1) / bits;
+			if (static_cast<size_t>(last - first) < count) {
+				return {last, std::errc::value_too_large};
+			}
+			return {write_pow2(first, value.digits_.cbegin(), n, bits), std::errc()};
+		}
+		size_t width = max_digits(n, base);
+		scratch_frame frame;
+		char* buffer = reinterpret_cast<char*>(frame.allocate((width + 3) / 4));
+		if (n < TO_CHARS_SPLIT_LIMBS) {
+			uint32_t* copy = frame.allocate(n);
+			std::copy_n(value.digits_.cbegin(), n, copy);
+			write_chunks(buffer, width, copy, n, base);
+		} else {
+			write_split(buffer, width, abs(value), base);
+		}
+		char const* digits = std::find_if(buffer, buffer + width, [](char c) { return c != '0'; });
+		size_t count = buffer + width - digits;
+		if (static_cast<size_t>(last - first) < count) {
+			return {last, std::errc::value_too_large};
+		}
+		return {std::copy_n(digits, count, first), std::errc()};
+	}
+
+	static std::to_chars_result to_chars(char* first, char* last, big_integer const& value, int base) {
+		BIGINT_STATS_SCOPE(to_string, value.digits_.size());
+		check_base(base);
+		if (value.sign_ == _NEGATIVE) {
+			if (first == last) {
+				return {last, std::errc::value_too_large};
+			}
+			*first++ = '-';
+		}
+		return write_magnitude(first, last, value, base);
+	}
+
+	static void read_pow2(big_integer& out, char const* first, char const* last, uint32_t bits) {
+		size_t n = ((last - first) * bits + 31) / 32;
+		scratch_frame frame;
+		uint32_t* x = frame.allocate(n);
+		std::fill_n(x, n, 0);
+		size_t pos = 0;
+		for (char const* p = last; p != first; pos += bits) {
+			uint32_t v = digit_value(*--p);
+			size_t limb = pos / 32;
+			uint32_t offset = pos % 32;
+			x[limb] |= v << offset;
+			if (offset + bits > 32) {
+				x[limb + 1] |= v >> (32 - offset);
+			}
+		}
+		out.assign_digits(x, n, _POSITIVE);
+	}
+
+	static void read_chunks(big_integer& out, char const* first, char const* last, int base) {
+		uint32_t const digits = chunk_digits(base);
+		size_t len = last - first;
+		scratch_frame frame;
+		uint32_t* x = frame.allocate(len / digits + 1);
+		size_t n = 0;
+		size_t step = len % digits ? len % digits : digits;
+		for (char const* p = first; p != last; p += step, step = digits) {
+			uint32_t v = 0;
+			for (char const* q = p; q != p + step; q++) {
+				v = v * base + digit_value(*q);
+			}
+			uint32_t carry = limbs::mul_1(x, x, n, power(base, step));
+			carry += limbs::add_1(x, x, n, v);
+			if (carry != 0) {
+				x[n++] = carry;
+			}
+		}
+		out.assign_digits(x, n, _POSITIVE);
+	}
+
+	static void read_split(big_integer& out, char const* first, char const* last, int base) {
+		size_t digits = chunk_digits(base);
+		size_t len = last - first;
+		if (len < FROM_CHARS_SPLIT_CHUNKS * digits) {
+			read_chunks(out, first, last, base);
+			return;
+		}
+		size_t k = 0;
+		while ((digits << (k + 1)) < len) {
+			k++;
+		}
+		big_integer low;
+		read_split(out, first, last - (digits << k), base);
+		read_split(low, last - (digits << k), last, base);
+		out *= split_power(base, k);
+		out += low;
+	}
+
+	static std::from_chars_result from_chars(char const* first, char const* last, big_integer& value, int base) {
+		BIGINT_STATS_SCOPE(from_string, static_cast<size_t>(last - first + 7) / 8);
+		check_base(base);
+		char const* p = first;
+		bool sign = p != last && *p == '-';
+		p += sign;
+		char const* begin = p;
+		while (p != last && digit_value(*p) < static_cast<uint32_t>(base)) {
+			p++;
+		}
+		if (p == begin) {
+			return {first, std::errc::invalid_argument};
+		}
+		while (begin != p && *begin == '0') {
+			begin++;
+		}
+		uint32_t bits = bits_per_digit(base);
+		if (bits) {
+			read_pow2(value, begin, p, bits);
+		} else {
+			read_split(value, begin, p, base);
+		}
+		value.sign_ = !value.digits_.empty() && sign ? _NEGATIVE : _POSITIVE;
+		return {p, std::errc()};
+	}
+
+	// Base selected by the basefield of a stream, zero if none is set.
+	static int stream_base(std::ios_base::fmtflags flags) {
+		switch (flags & std::ios_base::basefield) {
+		case std::ios_base::hex:
+			return 16;
+		case std::ios_base::oct:
+			return 8;
+		case std::ios_base::dec:
+			return 10;
+		default:
+			return 0;
+		}
+	}
+
+	static bool put(std::streambuf* buf, char const* data, size_t size) {
+		return buf->sputn(data, static_cast<std::streamsize>(size)) == static_cast<std::streamsize>(size);
+	}
+
+	static bool pad(std::streambuf* buf, char fill, size_t count) {
+		char run[64];
+		std::fill_n(run, sizeof(run), fill);
+		for (; count > sizeof(run); count -= sizeof(run)) {
+			if (!put(buf, run, sizeof(run))) {
+				return false;
+			}
+		}
+		return put(buf, run, count);
+	}
+
+	// Formats like the stream would format an integer: basefield, showbase,
+	// showpos, uppercase, width, fill and adjustfield are honored.
+	static void write_stream(std::ostream& s, big_integer const& value) {
+		std::ios_base::fmtflags flags = s.flags();
+		int base = stream_base(flags) ? stream_base(flags) : 10;
+		char prefix[3];
+		size_t prefix_len = 0;
+		if (value.sign_ == _NEGATIVE) {
+			prefix[prefix_len++] = '-';
+		} else if (flags & std::ios_base::showpos) {
+			prefix[prefix_len++] = '+';
+		}
+		if ((flags & std::ios_base::showbase) && base != 10 && !value.digits_.empty()) {
+			prefix[prefix_len++] = '0';
+			if (base == 16) {
+				prefix[prefix_len++] = flags & std::ios_base::uppercase ? 'X' : 'x';
+			}
+		}
+		size_t capacity = max_digits(std::max<size_t>(value.digits_.size(), 1), base);
+		scratch_frame frame;
+		char* digits = reinterpret_cast<char*>(frame.allocate((capacity + 3) / 4));
+		size_t count = write_magnitude(digits, digits + capacity, value, base).ptr - digits;
+		if (flags & std::ios_base::uppercase) {
+			std::transform(digits, digits + count, digits, [](char c) { return c >= 'a' ? static_cast<char>(c - 'a' + 'A') : c; });
+		}
+		size_t width = s.width() > 0 ? static_cast<size_t>(s.width()) : 0;
+		size_t padding = width > prefix_len + count ? width - prefix_len - count : 0;
+		std::ios_base::fmtflags adjust = flags & std::ios_base::adjustfield;
+		std::streambuf* buf = s.rdbuf();
+		bool ok = (adjust == std::ios_base::left || adjust == std::ios_base::internal || pad(buf, s.fill(), padding))
+			&& put(buf, prefix, prefix_len)
+			&& (adjust != std::ios_base::internal || pad(buf, s.fill(), padding))
+			&& put(buf, digits, count)
+			&& (adjust != std::ios_base::left || pad(buf, s.fill(), padding));
+		s.width(0);
+		if (!ok) {
+			s.setstate(std::ios_base::badbit);
+		}
+	}
+
+	// value = value * scale + chunk on a normalized magnitude.
+	static void push_chunk(big_integer& value, uint32_t chunk, uint32_t scale) {
+		size_t n = value.digits_.size();
+		uint32_t* d = value.digits_.begin();
+		uint32_t carry = limbs::mul_1(d, d, n, scale);
+		carry += limbs::add_1(d, d, n, chunk);
+		if (carry != 0) {
+			value.digits_.push_back(carry);
+		}
+	}
+
+	// Reads an optional sign and the longest run of digits straight from
+	// the stream buffer, a limb-sized chunk at a time. Without a basefield
+	// the base follows the prefix, as for built-in integers.
+	static void read_stream(std::istream& s, big_integer& value) {
+		using traits = std::istream::traits_type;
+		std::streambuf* buf = s.rdbuf();
+		int base = stream_base(s.flags());
+		traits::int_type c = buf->sgetc();
+		bool negative = traits::eq_int_type(c, traits::to_int_type('-'));
+		if (negative || traits::eq_int_type(c, traits::to_int_type('+'))) {
+			c = buf->snextc();
+		}
+		bool any = false;
+		if (base == 0) {
+			base = 10;
+			if (traits::eq_int_type(c, traits::to_int_type('0'))) {
+				base = 8;
+				any = true;
+				c = buf->snextc();
+				if (traits::eq_int_type(c, traits::to_int_type('x')) || traits::eq_int_type(c, traits::to_int_type('X'))) {
+					base = 16;
+					any = false;
+					c = buf->snextc();
+				}
+			}
+		}
+		uint32_t const digits = chunk_digits(base);
+		big_integer result;
+		uint32_t chunk = 0;
+		uint32_t chunk_len = 0;
+		for (; !traits::eq_int_type(c, traits::eof()); c = buf->snextc()) {
+			uint32_t d = digit_value(traits::to_char_type(c));
+			if (d >= static_cast<uint32_t>(base)) {
+				break;
+			}
+			any = true;
+			chunk = chunk * base + d;
+			if (++chunk_len == digits) {
+				push_chunk(result, chunk, power(base, digits));
+				chunk = 0;
+				chunk_len = 0;
+			}
+		}
+		if (chunk_len != 0) {
+			push_chunk(result, chunk, power(base, chunk_len));
+		}
+		std::ios_base::iostate state = std::ios_base::goodbit;
+		if (traits::eq_int_type(c, traits::eof())) {
+			state |= std::ios_base::eofbit;
+		}
+		if (any) {
+			result.sign_ = !result.digits_.empty() && negative ? _NEGATIVE : _POSITIVE;
+			swap(value, result);
+		} else {
+			state |= std::ios_base::failbit;
+		}
+		s.setstate(state);
+	}
+};
+
+std::to_chars_result to_chars(char* first, char* last, big_integer const& value, int base) {
+	return radix_conversion::to_chars(first, last, value, base);
+}
+
+std::from_chars_result from_chars(char const* first, char const* last, big_integer& value, int base) {
+	return radix_conversion::from_chars(first, last, value, base);
+}
+
+std::ostream& operator<<(std::ostream& s, big_integer const& a) {
+	std::ostream::sentry sentry(s);
+	if (sentry) {
+		radix_conversion::write_stream(s, a);
+	}
+	return s;
+}
+
+std::istream& operator>>(std::istream& s, big_integer& a) {
+	std::istream::sentry sentry(s);
+	if (sentry) {
+		radix_conversion::read_stream(s, a);
+	}
+	return s;
+}
+
+std::string to_string(big_integer const& a, int base) {
+	radix_conversion::check_base(base);
+	std::string result(radix_conversion::max_chars(a, base), '\0');
+	char* first = &result[0];
+	result.resize(to_chars(first, first + result.size(), a, base).ptr - first);
+	return result;
+}
+
+std::string to_string(big_integer const& a) {
+	return to_string(a, 10);
+}
+
+big_integer from_string(std::string const& str, int base) {
+	char const* first = str.data();
+	char const* last = first + str.size();
+	if (first != last && *first == '+' && ++first != last && *first == '-') {
+		throw std::runtime_error("Expected number, actual: " + str);
+	}
+	big_integer result;
+	std::from_chars_result parsed = from_chars(first, last, result, base);
+	if (parsed.ec != std::errc() || parsed.ptr != last) {
+		throw std::runtime_error("Expected number, actual: " + str);
+	}
+	return result;
+}
@@ -0,0 +1,45 @@
+#include "big_integer_stats.h"
+
+namespace {
+char const* const NAMES[big_integer_stats::OPERATIONS] = {
+	"add", "sub", "mul", "div", "mod", "bitwise", "shift", "to_string", "from_string"
+};
+}
+
+char const* big_integer_stats::name(big_integer_op op) {
+	return NAMES[static_cast<size_t>(op)];
+}
+
+big_integer_stats big_integer_stats::snapshot() {
+	big_integer_stats result = {};
+#ifdef BIGINT_STATS
+	stats_detail::counters const& c = stats_detail::global;
+	for (size_t i = 0; i < OPERATIONS; i++) {
+		result.operations[i].calls = c.operations[i].calls.load(std::memory_order_relaxed);
+		result.operations[i].cycles = c.operations[i].cycles.load(std::memory_order_relaxed);
+		for (size_t j = 0; j < BUCKETS; j++) {
+			result.operations[i].limbs[j] = c.operations[i].limbs[j].load(std::memory_order_relaxed);
+		}
+	}
+	result.allocations = c.allocations.load(std::memory_order_relaxed);
+	result.cow_copies = c.cow_copies.load(std::memory_order_relaxed);
+	result.promotions = c.promotions.load(std::memory_order_relaxed);
+#endif
+	return result;
+}
+
+void big_integer_stats::reset() {
+#ifdef BIGINT_STATS
+	stats_detail::counters& c = stats_detail::global;
+	for (stats_detail::operation_counters& op : c.operations) {
+		op.calls.store(0, std::memory_order_relaxed);
+		op.cycles.store(0, std::memory_order_relaxed);
+		for (std::atomic<uint64_t>& bucket : op.limbs) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+	c.allocations.store(0, std::memory_order_relaxed);
+	c.cow_copies.store(0, std::memory_order_relaxed);
+	c.promotions.store(0, std::memory_order_relaxed);
+#endif
+}
@@ -0,0 +1,150 @@
+#ifndef BIGINT_BIG_INTEGER_STATS_H
+#define BIGINT_BIG_INTEGER_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BIGINT_STATS
+#include <atomic>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+enum class big_integer_op {
+	add,
+	sub,
+	mul,
+	div,
+	mod,
+	bitwise,
+	shift,
+	to_string,
+	from_string
+};
+
+// Counters kept by the library when it is built with BIGINT_STATS defined
+// (cmake -DBIGINT_STATS=ON). Without it the hooks expand to nothing and
+// snapshot() returns zeros.
+//
+// An operation is counted once, where it is called from outside the
+// library: a shift that divides internally is one shift and no division,
+// and its cycles include the division. Cycles are read from the time stamp
+// counter where there is one and are nanoseconds elsewhere.
+struct big_integer_stats {
+#ifdef BIGINT_STATS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+	static constexpr size_t OPERATIONS = 9;
+	// Bucket 0 counts operations on zero limbs and bucket i > 0 those on
+	// [2^(i-1), 2^i) limbs; the last one takes everything longer. The size
+	// is that of the longer operand, or of the input over eight characters
+	// for parsing.
+	static constexpr size_t BUCKETS = 22;
+
+	struct operation {
+		uint64_t calls;
+		uint64_t cycles;
+		uint64_t limbs[BUCKETS];
+	};
+
+	operation operations[OPERATIONS];
+	// Allocations from the limb resource: a header per buffer and every
+	// limb array, including the reallocations of a growing buffer.
+	uint64_t allocations;
+	// Shared or borrowed limbs copied before a write.
+	uint64_t cow_copies;
+	// Values moved out of the small buffer.
+	uint64_t promotions;
+
+	operation const& operator[](big_integer_op op) const {
+		return operations[static_cast<size_t>(op)];
+	}
+
+	static char const* name(big_integer_op op);
+	static big_integer_stats snapshot();
+	static void reset();
+};
+
+#ifdef BIGINT_STATS
+namespace stats_detail {
+
+struct operation_counters {
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> cycles;
+	std::atomic<uint64_t> limbs[big_integer_stats::BUCKETS];
+};
+
+struct counters {
+	operation_counters operations[big_integer_stats::OPERATIONS];
+	std::atomic<uint64_t> allocations;
+	std::atomic<uint64_t> cow_copies;
+	std::atomic<uint64_t> promotions;
+};
+
+inline counters global;
+
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline size_t bucket(size_t limbs) {
+	size_t result = 0;
+	for (; limbs != 0 && result + 1 < big_integer_stats::BUCKETS; limbs >>= 1u) {
+		result++;
+	}
+	return result;
+}
+
+// Times an operation unless the thread is already inside one.
+class op_scope {
+public:
+	op_scope(big_integer_op op, size_t limbs) : op_(op), limbs_(limbs), outer_(depth()++ == 0), start_(0) {
+		if (outer_) {
+			start_ = ticks();
+		}
+	}
+
+	op_scope(op_scope const&) = delete;
+	op_scope& operator=(op_scope const&) = delete;
+
+	~op_scope() {
+		depth()--;
+		if (outer_) {
+			operation_counters& c = global.operations[static_cast<size_t>(op_)];
+			c.cycles.fetch_add(ticks() - start_, std::memory_order_relaxed);
+			c.calls.fetch_add(1, std::memory_order_relaxed);
+			c.limbs[bucket(limbs_)].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	big_integer_op op_;
+	size_t limbs_;
+	bool outer_;
+	uint64_t start_;
+
+	static size_t& depth() {
+		static thread_local size_t value = 0;
+		return value;
+	}
+};
+
+} // namespace stats_detail
+
+#define BIGINT_STATS_COUNT(counter) ::stats_detail::global.counter.fetch_add(1, std::memory_order_relaxed)
+#define BIGINT_STATS_SCOPE(op, limbs) ::stats_detail::op_scope bigint_stats_scope_(big_integer_op::op, (limbs))
+#else
+#define BIGINT_STATS_COUNT(counter) static_cast<void>(0)
+#define BIGINT_STATS_SCOPE(op, limbs) static_cast<void>(0)
+#endif
+
+#endif //BIGINT_BIG_INTEGER_STATS_H
@@ -1,13 +1,36 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <random>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 #include <utility>
+#include <memory_resource>
 #include <gtest/gtest.h>
 
+#include "big_decimal.h"
+#include "big_divisor.h"
 #include "big_integer.h"
 #include "big_integer_gmp.h"
+#include "big_rational.h"
+#include "big_integer_stats.h"
+#include "big_integer_view.h"
+#include "limb_batch.h"
+#include "limb_dispatch.h"
+#include "limb_kernels.h"
+#include "mapped_file.h"
+#include "number_theory.h"
+#include "serialization.h"
+#include "thread_pool.h"
+#include "wide_int.h"
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -67,6 +90,24 @@ TEST(correctness, self_assignment) {
   EXPECT_TRUE(a == 5);
 }
 
+TEST(correctness, move_assignment_leaves_zero) {
+  big_integer a = -5;
+  big_integer b = 7;
+  a = std::move(b);
+
+  EXPECT_EQ(7, a);
+  EXPECT_TRUE(b == 0);
+  EXPECT_TRUE(b == big_integer(0));
+  EXPECT_EQ("0", to_string(b));
+
+  big_integer c = -(big_integer(1) << 200);
+  big_integer d = big_integer(1) << 200;
+  c = std::move(d);
+  EXPECT_EQ("0", to_string(d));
+  d += 3;
+  EXPECT_EQ(3, d);
+}
+
 TEST(correctness, assignment_return_value) {
   big_integer a = 4;
   big_integer b = 7;
@@ -548,6 +589,28 @@ TEST(correctness, shl_long) {
             big_integer("12341236412857618761234871264871264128736412836643859238479") << 31);
 }
 
+TEST(correctness, shl_whole_limbs) {
+  big_integer a = 5;
+  for (int i = 0; i != 8; ++i) {
+    a <<= 32;
+    a += 5;
+  }
+
+  EXPECT_EQ(big_integer("578960446321380710484993632701015526708982950238446131684064403211200118128645"), a);
+  EXPECT_EQ(big_integer("26959946667150639794667015087019630673637144422540572481103610249216"), big_integer(1) << 224);
+  EXPECT_EQ(0, big_integer(0) << 100);
+}
+
+TEST(correctness, shl_after_shrink) {
+  big_integer a = (big_integer(1) << 320) + 5;
+  a -= big_integer(1) << 320;
+  big_integer b = a;
+
+  EXPECT_EQ(big_integer(5) << 40, a << 40);
+  EXPECT_EQ(5, b);
+  EXPECT_EQ(-(big_integer(5) << 40), (-a) << 40);
+}
+
 TEST(correctness, shr_long) {
   EXPECT_EQ(big_integer("4730073393008085198307104580698364137020387111323398632330851"),
             big_integer("151362348576258726345827346582347652384652387562348756234587245") >> 5);
@@ -577,6 +640,466 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, limb_resource) {
+  big_integer outside = big_integer(1) << 200;
+  alignas(std::max_align_t) char buffer[1 << 14];
+  std::pmr::monotonic_buffer_resource pool(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  {
+    scoped_limb_resource scope(&pool);
+    big_integer shared = outside;
+    big_integer a = big_integer(1) << 1000;
+    a *= a;
+    shared += 1;
+    EXPECT_EQ(big_integer(1) << 2000, a);
+    EXPECT_EQ((big_integer(1) << 200) + 1, shared);
+  }
+  EXPECT_EQ(big_integer(1) << 200, outside);
+}
+
+TEST(correctness, limb_resource_unshare) {
+  // The pool takes its chunks from the heap, so reading a value that was
+  // left in it after release() is caught by ASan.
+  big_integer a = big_integer(1) << 200;
+  big_integer grown = big_integer(1) << 300;
+  {
+    std::pmr::monotonic_buffer_resource pool;
+    {
+      scoped_limb_resource scope(&pool);
+      big_integer b = a;
+      a += 1;
+      big_integer c = grown;
+      grown <<= 4000;
+      EXPECT_EQ(big_integer(1) << 200, b);
+      EXPECT_EQ(big_integer(1) << 300, c);
+    }
+    pool.release();
+  }
+  EXPECT_EQ((big_integer(1) << 200) + 1, a);
+  EXPECT_EQ(big_integer(1) << 4300, grown);
+}
+
+TEST(correctness, hash) {
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  big_integer small = 12345;
+  big_integer promoted = (small << 320) >> 320;
+
+  EXPECT_EQ(hash_value(small), hash_value(promoted));
+  EXPECT_EQ(std::hash<big_integer>()(a), std::hash<big_integer>()((a << 96) >> 96));
+  EXPECT_EQ(hash_value(a), hash_value(a, 0));
+  EXPECT_NE(hash_value(a), hash_value(-a));
+  EXPECT_NE(hash_value(a, 1), hash_value(a, 2));
+  EXPECT_NE(hash_value(big_integer(0)), hash_value(big_integer(1)));
+}
+
+TEST(correctness, hash_cache_invalidation) {
+  big_integer a = big_integer(1) << 400;
+  big_integer shared = a;
+  uint64_t before = hash_value(a);
+  a += 1;
+
+  EXPECT_EQ(before, hash_value(shared));
+  EXPECT_EQ(hash_value((big_integer(1) << 400) + 1), hash_value(a));
+  EXPECT_NE(before, hash_value(a));
+}
+
+TEST(correctness, unordered_set) {
+  std::unordered_set<big_integer> set;
+  for (int i = 0; i != 100; ++i) {
+    set.insert(big_integer(i) << (i * 7));
+    set.insert(big_integer(i) << (i * 7));
+  }
+
+  EXPECT_EQ(100u, set.size());
+  EXPECT_EQ(1u, set.count(big_integer(99) << 693));
+  EXPECT_EQ(0u, set.count(big_integer(99) << 692));
+}
+
+TEST(correctness, serialization) {
+  std::vector<big_integer> values = {0, 1, -1, std::numeric_limits<int>::min(),
+                                     big_integer("-123456789012345678901234567890123456789"),
+                                     big_integer(1) << 1000};
+  std::vector<uint8_t> buffer;
+  for (big_integer const& v : values)
+    serialize(v, buffer);
+
+  EXPECT_EQ(8u, serialized_size(0));
+  EXPECT_EQ(12u, serialized_size(-1));
+  byte_span in = {buffer.data(), buffer.size()};
+  for (big_integer const& v : values) {
+    big_integer r;
+    size_t used = deserialize(in, r);
+    EXPECT_EQ(v, r);
+    EXPECT_EQ(serialized_size(v), used);
+    in.data += used;
+    in.size -= used;
+  }
+  EXPECT_EQ(0u, in.size);
+
+  EXPECT_THROW(deserialize(byte_span{buffer.data(), 4}), std::runtime_error);
+  size_t last = serialized_size(values.back());
+  EXPECT_THROW(deserialize(byte_span{buffer.data() + buffer.size() - last, last - 4}), std::runtime_error);
+}
+
+TEST(correctness, serialization_stream) {
+  std::stringstream stream;
+  {
+    big_integer_writer writer(stream, 64);
+    for (int i = 0; i != 1000; ++i)
+      writer.write((big_integer(i) << (i % 300)) * (i % 2 ? -1 : 1));
+  }
+
+  big_integer_reader reader(stream, 64);
+  big_integer value;
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_TRUE(reader.read(value));
+    EXPECT_EQ((big_integer(i) << (i % 300)) * (i % 2 ? -1 : 1), value);
+  }
+  EXPECT_FALSE(reader.read(value));
+
+  // A header claiming 2^40 limbs in front of a few bytes.
+  std::stringstream hostile;
+  uint64_t header = uint64_t(1) << 41;
+  for (size_t i = 0; i != 8; ++i)
+    hostile.put(static_cast<char>(header >> (8 * i)));
+  hostile.write("\1\2\3\4\5\6\7", 7);
+  big_integer_reader hostile_reader(hostile, 64);
+  EXPECT_THROW(hostile_reader.read(value), std::runtime_error);
+}
+
+TEST(correctness, view) {
+  big_integer a = big_integer("-98765432109876543210987654321098765432109876543210");
+  big_integer b = big_integer(7) << 300;
+  std::vector<uint8_t> buffer;
+  serialize(a, buffer);
+  serialize(b, buffer);
+
+  size_t used;
+  big_integer_view va = big_integer_view::from_record({buffer.data(), buffer.size()}, used);
+  big_integer_view vb = big_integer_view::from_record({buffer.data() + used, buffer.size() - used});
+
+  EXPECT_EQ(a, va);
+  EXPECT_TRUE(vb > va);
+  EXPECT_EQ(a + b, va + vb);
+  EXPECT_EQ(a * b, va * b);
+  EXPECT_EQ(b % a, vb % va);
+  EXPECT_EQ(hash_value(a), hash_value(va));
+  EXPECT_EQ(hash_value(b, 3), hash_value(vb, 3));
+
+  big_integer written = vb;
+  written += 1;
+  EXPECT_EQ(b + 1, written);
+  EXPECT_EQ(b, vb);
+  EXPECT_EQ(b, deserialize(byte_span{buffer.data() + used, buffer.size() - used}));
+}
+
+TEST(correctness, mapped_file) {
+  char const* path = "big_integer_mapped_file_test.bin";
+  {
+    std::ofstream out(path, std::ios::binary);
+    big_integer_writer writer(out);
+    for (int i = 0; i != 500; ++i)
+      writer.write(big_integer(i - 250) << (i % 100));
+  }
+  {
+    mapped_big_integer_file file(path);
+    int i = 0;
+    for (big_integer_view v : file) {
+      EXPECT_EQ(big_integer(i - 250) << (i % 100), v);
+      ++i;
+    }
+    EXPECT_EQ(500, i);
+
+    std::vector<size_t> index = file.index();
+    ASSERT_EQ(500u, index.size());
+    EXPECT_EQ(big_integer(123 - 250) << 23, file.at(index[123]));
+  }
+  std::remove(path);
+}
+
+TEST(correctness, radix_power_of_two) {
+  big_integer a = (big_integer(0xDEAD) << 64) + 0xBEEF;
+
+  EXPECT_EQ("dead000000000000beef", to_string(a, 16));
+  EXPECT_EQ("-dead000000000000beef", to_string(-a, 16));
+  EXPECT_EQ("1101", to_string(big_integer(13), 2));
+  EXPECT_EQ("777", to_string(big_integer(511), 8));
+  EXPECT_EQ("v", to_string(big_integer(31), 32));
+  EXPECT_EQ("0", to_string(big_integer(0), 16));
+  EXPECT_EQ(a, from_string("DEAD000000000000beef", 16));
+  EXPECT_EQ(-a, from_string("-0000dead000000000000BEEF", 16));
+  EXPECT_EQ(big_integer(1) << 1000, from_string("1" + std::string(1000, '0'), 2));
+  EXPECT_EQ(big_integer(1) << 999, from_string("1" + std::string(333, '0'), 8));
+}
+
+TEST(correctness, radix_round_trip) {
+  std::mt19937 rng(31);
+  for (int base = 2; base <= 36; base++) {
+    for (size_t digits : {1, 7, 40, 300, 2500}) {
+      std::string str(1, "123456789abcdefghijklmnopqrstuvwxyz"[rng() % (base - 1)]);
+      big_integer expected = from_string(str, base);
+      for (size_t i = 1; i < digits; i++) {
+        uint32_t d = rng() % base;
+        str += "0123456789abcdefghijklmnopqrstuvwxyz"[d];
+        expected = expected * base + static_cast<int>(d);
+      }
+      ASSERT_EQ(expected, from_string(str, base)) << "base " << base;
+      ASSERT_EQ(str, to_string(expected, base)) << "base " << base;
+      ASSERT_EQ("-" + str, to_string(-expected, base)) << "base " << base;
+    }
+  }
+}
+
+TEST(correctness, radix_decimal_large) {
+  std::string str = "9" + std::string(5000, '0') + "1";
+  big_integer a(str);
+
+  EXPECT_EQ(str, to_string(a));
+  EXPECT_EQ(a, from_string(str));
+  EXPECT_EQ("9" + std::string(5000, '0'), to_string(a / 10));
+  EXPECT_EQ(std::string(5002, '9'), to_string(big_integer("1" + std::string(5002, '0')) - 1));
+}
+
+TEST(correctness, radix_chars) {
+  big_integer a = -(big_integer(1) << 100);
+  char buffer[40];
+
+  std::to_chars_result printed = to_chars(buffer, buffer + sizeof(buffer), a, 16);
+  EXPECT_EQ(std::errc(), printed.ec);
+  EXPECT_EQ("-10000000000000000000000000", std::string(buffer, printed.ptr));
+  printed = to_chars(buffer, buffer + 10, a);
+  EXPECT_EQ(std::errc::value_too_large, printed.ec);
+  EXPECT_EQ(buffer + 10, printed.ptr);
+
+  std::string text = "-ff zz";
+  big_integer b = 7;
+  std::from_chars_result parsed = from_chars(text.data(), text.data() + text.size(), b, 16);
+  EXPECT_EQ(std::errc(), parsed.ec);
+  EXPECT_EQ(text.data() + 3, parsed.ptr);
+  EXPECT_EQ(-255, b);
+  parsed = from_chars(text.data() + 4, text.data() + text.size(), b, 16);
+  EXPECT_EQ(std::errc::invalid_argument, parsed.ec);
+  EXPECT_EQ(text.data() + 4, parsed.ptr);
+  EXPECT_EQ(-255, b);
+  parsed = from_chars(text.data() + 4, text.data() + text.size(), b, 36);
+  EXPECT_EQ(35 * 36 + 35, b);
+}
+
+TEST(correctness, radix_errors) {
+  EXPECT_THROW(from_string("", 16), std::runtime_error);
+  EXPECT_THROW(from_string("-", 10), std::runtime_error);
+  EXPECT_THROW(from_string("+-1", 10), std::runtime_error);
+  EXPECT_THROW(from_string("12a", 10), std::runtime_error);
+  EXPECT_THROW(from_string("102", 2), std::runtime_error);
+  EXPECT_THROW(to_string(big_integer(1), 37), std::runtime_error);
+  EXPECT_THROW(from_string("1", 1), std::runtime_error);
+  EXPECT_EQ(5, from_string("+101", 2));
+  EXPECT_EQ(0, from_string("-0", 10));
+}
+
+TEST(correctness, stream_output) {
+  big_integer a = (big_integer(0xABC) << 64) + 1;
+  std::ostringstream out;
+
+  out << a << ' ' << -a << ' ' << big_integer(0);
+  EXPECT_EQ(to_string(a) + " " + to_string(-a) + " 0", out.str());
+  out.str("");
+  out << std::hex << a << ' ' << std::showbase << std::uppercase << -a << ' ' << std::oct << big_integer(8);
+  EXPECT_EQ("abc0000000000000001 -0XABC0000000000000001 010", out.str());
+  out.str("");
+  out << std::dec << std::noshowbase << std::showpos << std::setw(6) << big_integer(42) << '|'
+      << std::left << std::setfill('*') << std::setw(6) << big_integer(-42) << '|'
+      << std::internal << std::setw(6) << big_integer(-42) << '|' << big_integer(7);
+  EXPECT_EQ("   +42|-42***|-***42|+7", out.str());
+}
+
+TEST(correctness, stream_input) {
+  std::string huge = "-" + std::string(3000, '7');
+  std::istringstream in("  123 -ff " + huge + " +0x1F 017 x");
+  big_integer a, b, c, d, e;
+
+  in >> a >> std::hex >> b >> std::dec >> c;
+  EXPECT_EQ(123, a);
+  EXPECT_EQ(-255, b);
+  EXPECT_EQ(big_integer(huge), c);
+  in.unsetf(std::ios_base::basefield);
+  in >> d >> e;
+  EXPECT_EQ(31, d);
+  EXPECT_EQ(15, e);
+  EXPECT_TRUE(in.good());
+  in >> a;
+  EXPECT_TRUE(in.fail());
+  EXPECT_EQ(123, a);
+
+  std::istringstream tail("-0042");
+  tail >> a;
+  EXPECT_EQ(-42, a);
+  EXPECT_TRUE(tail.eof());
+  EXPECT_FALSE(tail.fail());
+}
+
+TEST(correctness, stream_round_trip) {
+  std::mt19937 rng(32);
+  std::vector<big_integer> values;
+  for (size_t i = 0; i < 100; i++) {
+    big_integer x = static_cast<int>(rng() >> 1u);
+    x <<= static_cast<int>(rng() % 2000);
+    values.push_back(i % 2 ? -x : x);
+  }
+  for (auto base : {std::dec, std::hex, std::oct}) {
+    std::stringstream stream;
+    for (big_integer const& x : values) {
+      stream << base << x << '\n';
+    }
+    for (big_integer const& x : values) {
+      big_integer y;
+      stream >> base >> y;
+      ASSERT_EQ(x, y);
+    }
+  }
+}
+
+TEST(correctness, batch) {
+  std::mt19937 rng(33);
+  for (size_t count : {1, 15, 16, 17, 100}) {
+    size_t const n = 3;
+    limb_batch a(n, count), b(n, count);
+    std::vector<big_integer> x, y;
+    for (size_t j = 0; j < count; j++) {
+      big_integer u = 0, v = 0;
+      for (size_t i = 0; i < n; i++) {
+        u = (u << 32) + static_cast<int>(rng() >> 1u);
+        v = (v << 32) + static_cast<int>(rng() >> 1u);
+      }
+      if (j % 3 == 0) {
+        u = u * 2 + 1;
+      }
+      x.push_back(u);
+      y.push_back(j % 4 == 0 ? u : v);
+      a.set(j, x[j]);
+      b.set(j, y[j]);
+    }
+    limb_batch sum(n, count), product(2 * n, count);
+    std::vector<uint32_t> carry(count);
+    std::vector<int> order(count);
+    add_n_batch(sum.data(), a.data(), b.data(), n, count, carry.data());
+    mul_batch(product.data(), a.data(), n, b.data(), n, count);
+    cmp_batch(order.data(), a.data(), b.data(), n, count);
+    for (size_t j = 0; j < count; j++) {
+      EXPECT_EQ(x[j] + y[j], (big_integer(static_cast<int>(carry[j])) << 96) + sum.get(j));
+      EXPECT_EQ(x[j] * y[j], product.get(j));
+      EXPECT_EQ(x[j] < y[j] ? -1 : x[j] > y[j] ? 1 : 0, order[j]);
+    }
+    add_n_batch(a.data(), a.data(), a.data(), n, count, carry.data());
+    EXPECT_EQ(x[0] * 2, (big_integer(static_cast<int>(carry[0])) << 96) + a.get(0));
+  }
+  limb_batch small(1, 1);
+  EXPECT_THROW(small.set(0, big_integer(1) << 32), std::runtime_error);
+  EXPECT_THROW(small.set(0, -1), std::runtime_error);
+}
+
+static_assert((wide_uint<128>(1) << 100) / (wide_uint<128>(1) << 60) == wide_uint<128>(1) << 40, "");
+static_assert(wide_int<256>(-7) / 2 == -3 && wide_int<256>(-7) % 2 == -1, "");
+static_assert(wide_uint<64>(0) - 1 == wide_uint<64>(UINT64_MAX), "");
+static_assert(wide_int<96>::min() < wide_int<96>(-1) && wide_int<96>::max() > wide_int<96>(0), "");
+
+TEST(correctness, wide_int_matches_int64) {
+  std::mt19937_64 rng(34);
+  for (size_t i = 0; i < 10000; i++) {
+    int64_t x = static_cast<int64_t>(rng()) >> (rng() % 64);
+    int64_t y = static_cast<int64_t>(rng()) >> (rng() % 64);
+    int shift = static_cast<int>(rng() % 64);
+    wide_int<64> a = x, b = y;
+    ASSERT_EQ(wide_int<64>(static_cast<int64_t>(static_cast<uint64_t>(x) + static_cast<uint64_t>(y))), a + b);
+    ASSERT_EQ(wide_int<64>(static_cast<int64_t>(static_cast<uint64_t>(x) - static_cast<uint64_t>(y))), a - b);
+    ASSERT_EQ(wide_int<64>(static_cast<int64_t>(static_cast<uint64_t>(x) * static_cast<uint64_t>(y))), a * b);
+    if (y != 0 && !(x == INT64_MIN && y == -1)) {
+      ASSERT_EQ(wide_int<64>(x / y), a / b);
+      ASSERT_EQ(wide_int<64>(x % y), a % b);
+    }
+    ASSERT_EQ(wide_int<64>(x >> shift), a >> shift);
+    ASSERT_EQ(wide_int<64>(static_cast<int64_t>(static_cast<uint64_t>(x) << shift)), a << shift);
+    ASSERT_EQ(x < y, a < b);
+    ASSERT_EQ(wide_int<64>(x & ~y), a & ~b);
+  }
+}
+
+TEST(correctness, wide_uint_matches_big_integer) {
+  std::mt19937 rng(34);
+  big_integer const modulus = big_integer(1) << 256;
+  auto wrap = [&](big_integer const& x) { return (x % modulus + modulus) % modulus; };
+  for (size_t i = 0; i < 2000; i++) {
+    big_integer x = 0, y = 0;
+    for (size_t k = rng() % 9; k > 0; k--) {
+      x = (x << 32) + static_cast<int>(rng() >> 1u);
+    }
+    for (size_t k = rng() % 9 + 1; k > 0; k--) {
+      y = (y << 32) + static_cast<int>(rng() >> 1u) + 1;
+    }
+    wide_uint<256> a(x), b(y);
+    ASSERT_EQ(wrap(x), big_integer(a));
+    ASSERT_EQ(wrap(x + y), big_integer(a + b));
+    ASSERT_EQ(wrap(x - y), big_integer(a - b));
+    ASSERT_EQ(wrap(x * y), big_integer(a * b));
+    ASSERT_EQ(wrap(x) / wrap(y), big_integer(a / b));
+    ASSERT_EQ(wrap(x) % wrap(y), big_integer(a % b));
+    ASSERT_EQ(wrap(x) < wrap(y), a < b);
+  }
+}
+
+TEST(correctness, wide_int_conversions) {
+  big_integer x("-123456789012345678901234567890");
+
+  EXPECT_EQ(x, big_integer(wide_int<128>(x)));
+  EXPECT_EQ(x, big_integer(wide_int<512>(wide_int<128>(x))));
+  EXPECT_EQ((big_integer(1) << 128) + x, big_integer(wide_uint<128>(x)));
+  EXPECT_EQ("-123456789012345678901234567890", to_string(wide_int<256>(x)));
+  EXPECT_EQ("ff", to_string(wide_uint<64>(255), 16));
+  EXPECT_EQ(big_integer(-1), big_integer(wide_int<256>(-1) >> 300));
+  EXPECT_EQ(big_integer(0), big_integer(wide_uint<256>(12345) << 256));
+  EXPECT_THROW(wide_uint<128>(1) / 0, std::runtime_error);
+}
+
+namespace {
+constexpr auto powers_of_ten = power_table<40>(wide_uint<192>(10));
+constexpr auto factorials = [] {
+  std::array<wide_uint<256>, 50> table{};
+  table[0] = 1;
+  for (size_t i = 1; i < table.size(); i++) {
+    table[i] = table[i - 1] * static_cast<uint32_t>(i);
+  }
+  return table;
+}();
+
+static_assert(powers_of_ten[39] / powers_of_ten[20] == powers_of_ten[19], "");
+static_assert(factorials[49] % wide_uint<256>(powers_of_ten[10]) == 0, "");
+static_assert(sizeof(4294967295_bi) == 8 && sizeof(999999999_bi) == 4, "");
+static_assert(-0x8000'0000_bi < 0 && 0b101_bi == 5 && 017_bi == 15, "");
+static_assert(pow(10_bi * 1, 3) == 1000, "");
+}
+
+TEST(correctness, compile_time_tables) {
+  big_integer ten_pow = 1;
+  big_integer factorial = 1;
+  for (size_t i = 0; i < 40; i++) {
+    EXPECT_EQ(ten_pow, big_integer(powers_of_ten[i]));
+    ten_pow *= 10;
+  }
+  for (size_t i = 1; i < 50; i++) {
+    factorial *= static_cast<int>(i);
+  }
+  EXPECT_EQ(factorial, big_integer(factorials[49]));
+}
+
+TEST(correctness, literal) {
+  big_integer a = 123456789012345678901234567890123456789_bi;
+  big_integer b = -0xFFFF'FFFF'FFFF'FFFF'FFFF'FFFF_bi;
+
+  EXPECT_EQ(big_integer("123456789012345678901234567890123456789"), a);
+  EXPECT_EQ(-((big_integer(1) << 96) - 1), b);
+  EXPECT_EQ(a * 2, 246913578024691357802469135780246913578_bi);
+  EXPECT_EQ(big_integer(0), 0_bi);
+}
+
 namespace {
 size_t const number_of_iterations = 10;
 size_t const max_size = 2048;
@@ -665,6 +1188,76 @@ TEST(correctness, mul_merge_randomized) {
   }
 }
 
+TEST(correctness, product) {
+  std::vector<big_integer> empty;
+  EXPECT_EQ(big_integer(1), product(empty.begin(), empty.end()));
+
+  std::vector<int> small = {3, -5, 7};
+  EXPECT_EQ(big_integer(-105), product(small.begin(), small.end()));
+
+  for (size_t n : {1, 2, 5, 100, 1000}) {
+    std::vector<big_integer> x;
+    big_integer expected = 1;
+    for (size_t i = 0; i != n; ++i) {
+      x.push_back(big_integer(myrand()) * (i + 1));
+      expected *= x.back();
+    }
+    EXPECT_EQ(expected, product(x.begin(), x.end()));
+    EXPECT_EQ(expected, product(x.data(), x.data() + x.size()));
+    scoped_thread_limit limit(4);
+    EXPECT_EQ(expected, product(x.begin(), x.end()));
+  }
+}
+
+TEST(correctness, factorial) {
+  big_integer_gmp expected = 1;
+  for (uint32_t n = 0; n <= 3000; ++n) {
+    if (n > 0) {
+      expected *= big_integer_gmp(static_cast<int>(n));
+    }
+    if (n < 100 || n % 97 == 0) {
+      EXPECT_EQ(to_string(expected), to_string(factorial(n)));
+    }
+  }
+}
+
+TEST(correctness, binomial) {
+  std::vector<big_integer_gmp> fact(1);
+  fact[0] = 1;
+  for (int i = 1; i <= 1200; ++i) {
+    fact.push_back(fact.back() * big_integer_gmp(i));
+  }
+  for (uint32_t n : {0, 1, 2, 10, 37, 100, 531, 1200}) {
+    for (uint32_t k : {0u, 1u, n / 3, n / 2, n - 1, n}) {
+      if (k > n) {
+        continue;
+      }
+      big_integer_gmp expected = fact[n] / (fact[k] * fact[n - k]);
+      EXPECT_EQ(to_string(expected), to_string(binomial(n, k)));
+    }
+  }
+  EXPECT_EQ(big_integer(0), binomial(5, 6));
+}
+
+TEST(correctness, primorial) {
+  EXPECT_EQ(big_integer(1), primorial(0));
+  EXPECT_EQ(big_integer(1), primorial(1));
+  EXPECT_EQ(big_integer(2), primorial(2));
+  EXPECT_EQ(big_integer(30), primorial(6));
+  EXPECT_EQ(big_integer(210), primorial(10));
+  big_integer_gmp expected = 1;
+  for (int n = 2; n <= 5000; ++n) {
+    bool prime = true;
+    for (int d = 2; d * d <= n; ++d) {
+      prime = prime && n % d != 0;
+    }
+    if (prime) {
+      expected *= big_integer_gmp(n);
+    }
+  }
+  EXPECT_EQ(to_string(expected), to_string(primorial(5000)));
+}
+
 namespace {
 big_integer rand_big(size_t size) {
   big_integer result = rand();
@@ -690,6 +1283,623 @@ TEST(correctness, div_randomized) {
   }
 }
 
+TEST(correctness, limb_counts) {
+  std::mt19937 rng(48);
+  for (size_t an = 1; an != 12; ++an) {
+    for (size_t bn = 1; bn <= an; ++bn) {
+      big_integer_gmp a, b;
+      a.random(32 * an - 1, rng);
+      b.random(32 * bn - 1, rng);
+      big_integer x(to_string(a)), y(to_string(b));
+      EXPECT_EQ(to_string(a * b), to_string(x * y));
+      EXPECT_EQ(to_string(a * a), to_string(x *= x));
+      if (b != 0) {
+        EXPECT_EQ(to_string(a / b), to_string(big_integer(to_string(a)) / y));
+        EXPECT_EQ(to_string(a % b), to_string(big_integer(to_string(a)) % y));
+        EXPECT_EQ(to_string(a % b), to_string(mod(big_integer(to_string(a)), big_divisor(y))));
+      }
+    }
+  }
+}
+
+TEST(correctness, small_operands) {
+  std::vector<int64_t> values = {0, 1, -1, 7, -7, INT32_MAX, INT32_MIN, UINT32_MAX, -int64_t(UINT32_MAX),
+                                 int64_t(1) << 32, (int64_t(1) << 32) + 1, -(int64_t(1) << 40), 999999999999};
+  for (int64_t a : values) {
+    for (int64_t b : values) {
+      big_integer x(std::to_string(a));
+      big_integer y(std::to_string(b));
+      EXPECT_EQ(big_integer(std::to_string(a + b)), x + b);
+      EXPECT_EQ(big_integer(std::to_string(a + b)), a + y);
+      EXPECT_EQ(big_integer(std::to_string(a - b)), x - b);
+      EXPECT_EQ(big_integer(std::to_string(a - b)), a - y);
+      EXPECT_EQ(a < b, x < b);
+      EXPECT_EQ(a < b, a < y);
+      EXPECT_EQ(a == b, x == b);
+      EXPECT_EQ(a >= b, x >= b);
+      if (b != 0) {
+        EXPECT_EQ(big_integer(std::to_string(a / b)), x / b);
+        EXPECT_EQ(big_integer(std::to_string(a % b)), x % b);
+      }
+      if (a > INT32_MIN && a <= INT32_MAX && b > INT32_MIN && b <= INT32_MAX) {
+        EXPECT_EQ(big_integer(std::to_string(a * b)), x * b);
+        EXPECT_EQ(big_integer(std::to_string(a * b)), a * y);
+      }
+    }
+  }
+}
+
+TEST(correctness, small_operands_wide) {
+  std::mt19937_64 rng(7);
+  uint64_t const small[] = {1, 3, UINT32_MAX, uint64_t(UINT32_MAX) + 1, UINT64_MAX, 0x8000000000000000ull};
+  for (size_t itn = 0; itn != 50; ++itn) {
+    big_integer x = rand_big(1 + itn % 8);
+    if (itn % 2) {
+      x = -x;
+    }
+    for (uint64_t s : small) {
+      big_integer y(std::to_string(s));
+      EXPECT_EQ(x + y, x + s);
+      EXPECT_EQ(x - y, x - s);
+      EXPECT_EQ(x, x + s - s);
+      EXPECT_EQ(x, x * s / s);
+      EXPECT_EQ(x, (x / s) * s + x % s);
+      EXPECT_LT(abs(x % s), y);
+      EXPECT_EQ(x < y, x < s);
+      EXPECT_EQ(x == x + s, false);
+      int64_t t = static_cast<int64_t>(rng());
+      EXPECT_EQ(x * big_integer(std::to_string(t)), x * t);
+      EXPECT_EQ(x - big_integer(std::to_string(t)), x - t);
+    }
+  }
+}
+
+TEST(correctness, small_operands_carry) {
+  big_integer a = (big_integer(1) << 160) - 1;
+  EXPECT_EQ(big_integer(1) << 160, a + 1u);
+  EXPECT_EQ(a, (big_integer(1) << 160) - 1ll);
+  EXPECT_EQ(-(big_integer(1) << 160), -a - 1ul);
+  EXPECT_EQ(big_integer(0), a - a);
+  EXPECT_EQ(big_integer(UINT64_MAX) + UINT64_MAX, big_integer(UINT64_MAX) * 2);
+  EXPECT_THROW(a / 0, std::runtime_error);
+  EXPECT_THROW(a % 0ull, std::runtime_error);
+}
+
+TEST(correctness, karatsuba) {
+  std::default_random_engine rng(42);
+  std::pair<size_t, size_t> const sizes[] = {{1000, 1000}, {2048, 2047}, {5000, 3000}, {20000, 900},
+                                             {40000, 39000}, {100000, 100000}, {150000, 60000}};
+  for (auto const& size : sizes) {
+    big_integer_gmp a, b;
+    a.random(size.first, rng);
+    b.random(size.second, rng);
+    big_integer A(to_string(a)), B(to_string(b));
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+    EXPECT_EQ(to_string(b * a), to_string(B * A));
+  }
+}
+
+TEST(correctness, karatsuba_carries) {
+  big_integer a = (big_integer(1) << 50000) - 1;
+  big_integer b = (big_integer(1) << 30000) - 1;
+  EXPECT_EQ((big_integer(1) << 100000) - (big_integer(1) << 50001) + 1, a * a);
+  EXPECT_EQ((big_integer(1) << 80000) - (big_integer(1) << 50000) - (big_integer(1) << 30000) + 1, a * b);
+}
+
+TEST(correctness, divisor_1) {
+  std::mt19937 rng(11);
+  uint32_t const divisors[] = {1, 2, 3, 7, 10, 1000000000, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFF};
+  for (uint32_t d : divisors) {
+    limbs::divisor_1 const divisor(d);
+    for (size_t n : {1, 2, 5, 40}) {
+      std::vector<uint32_t> a(n), q(n);
+      for (uint32_t& limb : a) {
+        limb = rng();
+      }
+      a[0] = d == 1 ? a[0] : 0xFFFFFFFF;
+      uint64_t rem = 0;
+      std::vector<uint32_t> expected(n);
+      for (size_t i = n; i > 0; i--) {
+        uint64_t cur = (rem << 32u) | a[i - 1];
+        expected[i - 1] = static_cast<uint32_t>(cur / d);
+        rem = cur % d;
+      }
+      EXPECT_EQ(rem, limbs::divrem_1(q.data(), a.data(), n, divisor));
+      EXPECT_EQ(expected, q);
+      EXPECT_EQ(rem, limbs::mod_1(a.data(), n, divisor));
+      EXPECT_EQ(rem, limbs::divrem_1(a.data(), a.data(), n, d));
+      EXPECT_EQ(expected, a);
+    }
+  }
+  static_assert(limbs::divisor_1(10).shift == 28, "shift of 10");
+}
+
+TEST(correctness, divisor_2) {
+  __extension__ typedef unsigned __int128 uint128_t;
+  std::mt19937 rng(13);
+  for (size_t i = 0; i < 10000; i++) {
+    uint32_t high = rng() | 0x80000000u, low = i % 3 == 0 ? 0 : rng();
+    if (i % 5 == 0) {
+      high = UINT32_MAX;
+      low = UINT32_MAX - i % 2;
+    }
+    limbs::divisor_2 const d(high, low);
+    uint128_t const base = static_cast<uint128_t>(1) << 32u;
+    uint128_t const value = (static_cast<uint128_t>(high) << 32u) | low;
+    EXPECT_EQ(static_cast<uint32_t>((base * base * base - 1) / value - base), d.inverse);
+
+    uint128_t top = (static_cast<uint128_t>(rng()) << 32u | rng()) % value;
+    uint128_t u = top << 32u | rng();
+    uint64_t r = 0;
+    EXPECT_EQ(static_cast<uint32_t>(u / value),
+              d.divide(static_cast<uint32_t>(u >> 64u), static_cast<uint32_t>(u >> 32u), static_cast<uint32_t>(u), r));
+    EXPECT_EQ(static_cast<uint64_t>(u % value), r);
+  }
+}
+
+TEST(correctness, big_divisor) {
+  EXPECT_THROW(big_divisor(0), std::runtime_error);
+  for (size_t bn : {0, 1, 2, 5, 20}) {
+    big_integer d = rand_big(bn);
+    if (d == 0) {
+      d = 3;
+    }
+    for (big_integer divisor : {d, -d, d << 17, (big_integer(1) << static_cast<int>(32 * bn + 32)) - 1}) {
+      big_divisor const prepared(divisor);
+      EXPECT_EQ(divisor, prepared.value());
+      for (size_t an : {0, 1, 2, 5, 20, 60}) {
+        big_integer a = rand_big(an);
+        for (big_integer x : {a, -a, divisor, divisor * a, divisor * a - 1, big_integer()}) {
+          EXPECT_EQ(x / divisor, divide(x, prepared));
+          EXPECT_EQ(x % divisor, mod(x, prepared));
+        }
+      }
+    }
+  }
+}
+
+TEST(correctness, kernel_tables) {
+  EXPECT_LE(limbs::kernels().tier, limbs::supported_tier());
+  std::mt19937 rng(17);
+  for (limbs::cpu_tier tier : {limbs::cpu_tier::generic, limbs::cpu_tier::bmi2_adx,
+                               limbs::cpu_tier::avx2, limbs::cpu_tier::avx512}) {
+    limbs::kernel_table const& k = limbs::kernels(tier);
+    EXPECT_EQ(std::min(tier, limbs::supported_tier()), k.tier);
+    for (size_t n : {0, 1, 2, 3, 7, 16, 33, 100}) {
+      std::vector<uint32_t> a(n), b(n), expected(n), actual(n);
+      for (size_t i = 0; i < n; i++) {
+        a[i] = i % 3 == 0 ? UINT32_MAX : rng();
+        b[i] = i % 4 == 0 ? UINT32_MAX : rng();
+      }
+      uint32_t m = n % 2 ? UINT32_MAX : rng();
+
+      EXPECT_EQ(limbs::add_n(expected.data(), a.data(), b.data(), n), k.add_n(actual.data(), a.data(), b.data(), n));
+      EXPECT_EQ(expected, actual);
+      EXPECT_EQ(limbs::sub_n(expected.data(), a.data(), b.data(), n), k.sub_n(actual.data(), a.data(), b.data(), n));
+      EXPECT_EQ(expected, actual);
+      EXPECT_EQ(limbs::mul_1(expected.data(), a.data(), n, m), k.mul_1(actual.data(), a.data(), n, m));
+      EXPECT_EQ(expected, actual);
+      actual = expected = b;
+      EXPECT_EQ(limbs::addmul_1(expected.data(), a.data(), n, m), k.addmul_1(actual.data(), a.data(), n, m));
+      EXPECT_EQ(expected, actual);
+
+      for (size_t i = 0; i < n; i++) {
+        expected[i] = a[i] & b[i];
+      }
+      k.and_n(actual.data(), a.data(), b.data(), n);
+      EXPECT_EQ(expected, actual);
+      for (size_t i = 0; i < n; i++) {
+        expected[i] = a[i] | b[i];
+      }
+      k.or_n(actual.data(), a.data(), b.data(), n);
+      EXPECT_EQ(expected, actual);
+      for (size_t i = 0; i < n; i++) {
+        expected[i] = a[i] ^ b[i];
+      }
+      k.xor_n(actual.data(), a.data(), b.data(), n);
+      EXPECT_EQ(expected, actual);
+
+      size_t ones = 0;
+      for (uint32_t limb : a) {
+        ones += std::bitset<32>(limb).count();
+      }
+      EXPECT_EQ(ones, k.popcount(a.data(), n));
+
+      actual = a;
+      EXPECT_EQ(limbs::add_n(expected.data(), a.data(), a.data(), n), k.add_n(actual.data(), actual.data(), actual.data(), n));
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+
+TEST(correctness, stats) {
+  big_integer_stats::reset();
+  big_integer a = big_integer(1) << 200;
+  big_integer b = a;
+  b += 1;
+  b -= a;
+  b *= a;
+  b /= 3;
+  a >>= 100;
+  a = a | b;
+  from_string("123456789012345678901234567890", 10);
+  to_string(a);
+  big_integer_stats const stats = big_integer_stats::snapshot();
+  if (!big_integer_stats::enabled) {
+    for (auto const& op : stats.operations) {
+      EXPECT_EQ(0u, op.calls);
+    }
+    EXPECT_EQ(0u, stats.allocations);
+    return;
+  }
+  EXPECT_EQ(1u, stats[big_integer_op::add].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::sub].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::mul].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::div].calls);
+  EXPECT_EQ(0u, stats[big_integer_op::mod].calls);
+  EXPECT_EQ(2u, stats[big_integer_op::shift].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::bitwise].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::from_string].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::to_string].calls);
+  EXPECT_EQ(1u, stats[big_integer_op::add].limbs[3]);
+  EXPECT_GE(stats.cow_copies, 1u);
+  EXPECT_GE(stats.promotions, 1u);
+  EXPECT_GE(stats.allocations, stats.promotions);
+  EXPECT_STREQ("from_string", big_integer_stats::name(big_integer_op::from_string));
+}
+
+TEST(correctness, stats_growth) {
+  big_integer a = big_integer(1) << 200;
+  big_integer_stats::reset();
+  for (int i = 0; i != 10; ++i) {
+    a <<= 1000;
+  }
+  big_integer_stats const stats = big_integer_stats::snapshot();
+  EXPECT_EQ((big_integer(1) << 10200), a);
+  if (!big_integer_stats::enabled) {
+    EXPECT_EQ(0u, stats.allocations);
+    return;
+  }
+  // The buffer grows in place, no new one is created.
+  EXPECT_EQ(0u, stats.promotions);
+  EXPECT_EQ(0u, stats.cow_copies);
+  EXPECT_GE(stats.allocations, 2u);
+}
+
+TEST(correctness, bit_queries) {
+  big_integer zero;
+  EXPECT_EQ(0u, zero.bit_length());
+  EXPECT_EQ(0u, zero.popcount());
+  EXPECT_EQ(0u, zero.ctz());
+  EXPECT_FALSE(zero.test_bit(0));
+
+  big_integer x = -(big_integer(1) << 100);
+  EXPECT_EQ(101u, x.bit_length());
+  EXPECT_EQ(1u, x.popcount());
+  EXPECT_EQ(100u, x.ctz());
+  EXPECT_TRUE(x.test_bit(100));
+  EXPECT_FALSE(x.test_bit(99));
+  EXPECT_FALSE(x.test_bit(1000));
+
+  x.set_bit(3).set_bit(200);
+  EXPECT_EQ(-(big_integer(1) << 100) - (big_integer(1) << 200) - 8, x);
+  x.clear_bit(200).clear_bit(100).clear_bit(3).clear_bit(5000);
+  EXPECT_EQ(0, x);
+  EXPECT_EQ("0", to_string(x));
+  EXPECT_EQ(big_integer(1) << 64, big_integer().set_bit(64));
+}
+
+TEST(correctness, bit_queries_randomized) {
+  for (size_t size : {0, 1, 3, 50, 500}) {
+    big_integer x = rand_big(size);
+    size_t length = 0, ones = 0, trailing = 0;
+    big_integer rest = x;
+    while (rest != 0) {
+      bool bit = (rest & 1) != 0;
+      EXPECT_EQ(bit, x.test_bit(length));
+      ones += bit;
+      trailing += ones == 0;
+      length++;
+      rest >>= 1;
+    }
+    EXPECT_EQ(length, x.bit_length());
+    EXPECT_EQ(ones, x.popcount());
+    EXPECT_EQ(trailing, x.ctz());
+    EXPECT_EQ(ones, (-x).popcount());
+    big_integer y = x;
+    y.clear_bit(length - 1);
+    EXPECT_EQ(x - (big_integer(1) << static_cast<int>(length - 1)), y);
+    y.set_bit(length - 1);
+    EXPECT_EQ(x, y);
+  }
+}
+
+TEST(correctness, parallel_mul) {
+  big_integer a = rand_big(8000), b = rand_big(7000);
+  big_integer serial = a * b;
+  for (size_t threads : {2, 3, 8}) {
+    scoped_thread_limit limit(threads);
+    EXPECT_EQ(threads, get_thread_limit());
+    EXPECT_EQ(serial, a * b);
+    EXPECT_EQ(serial * serial, (a * b) * (b * a));
+  }
+  EXPECT_EQ(1u, get_thread_limit());
+}
+
+TEST(correctness, thread_pool) {
+  thread_pool pool(3);
+  std::atomic<size_t> total(0);
+  task_group outer(pool);
+  for (size_t i = 0; i < 16; i++) {
+    outer.run([&pool, &total] {
+      task_group inner(pool);
+      for (size_t j = 0; j < 16; j++) {
+        inner.run([&total] { total++; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(256u, total.load());
+
+  task_group failing(pool);
+  failing.run([] { throw std::runtime_error("task failed"); });
+  failing.run([&total] { total++; });
+  EXPECT_THROW(failing.wait(), std::runtime_error);
+  EXPECT_EQ(257u, total.load());
+}
+
+namespace {
+bool gmp_is_prime(big_integer const& x) {
+  mpz_t value;
+  mpz_init_set_str(value, to_string(x).c_str(), 10);
+  bool result = mpz_probab_prime_p(value, 30) != 0;
+  mpz_clear(value);
+  return result;
+}
+
+big_integer gmp_next_prime(big_integer const& x) {
+  mpz_t value;
+  mpz_init_set_str(value, to_string(x).c_str(), 10);
+  mpz_nextprime(value, value);
+  char* str = mpz_get_str(nullptr, 10, value);
+  big_integer result(str);
+  void (*free_func)(void*, size_t);
+  mp_get_memory_functions(nullptr, nullptr, &free_func);
+  free_func(str, std::strlen(str) + 1);
+  mpz_clear(value);
+  return result;
+}
+}
+
+TEST(correctness, is_probable_prime_small) {
+  std::vector<bool> composite(200000);
+  for (size_t i = 2; i < composite.size(); ++i) {
+    for (size_t j = 2 * i; j < composite.size(); j += i) {
+      composite[j] = true;
+    }
+  }
+  for (size_t i = 0; i < composite.size(); ++i) {
+    ASSERT_EQ(i >= 2 && !composite[i], is_probable_prime(i)) << i;
+  }
+  EXPECT_FALSE(is_probable_prime(-7));
+  for (int64_t i = 999000; i < 1003000; ++i) {
+    ASSERT_EQ(gmp_is_prime(i), is_probable_prime(i)) << i;
+  }
+}
+
+TEST(correctness, is_probable_prime_large) {
+  EXPECT_TRUE(is_probable_prime((big_integer(1) << 61) - 1));
+  EXPECT_TRUE(is_probable_prime((big_integer(1) << 127) - 1));
+  EXPECT_TRUE(is_probable_prime((big_integer(1) << 521) - 1, 5));
+  EXPECT_FALSE(is_probable_prime((big_integer(1) << 67) - 1));
+  EXPECT_FALSE(is_probable_prime((big_integer(1) << 128) + 1));
+  // Strong pseudoprimes to base 2 that trial division does not catch.
+  EXPECT_FALSE(is_probable_prime(1194649));
+  EXPECT_FALSE(is_probable_prime(12327121));
+  EXPECT_FALSE(is_probable_prime(big_integer("3825123056546413051")));
+  EXPECT_FALSE(is_probable_prime(big_integer("318665857834031151167461")));
+  big_integer p("170141183460469231731687303715884105727");
+  big_integer q("618970019642690137449562111");
+  EXPECT_FALSE(is_probable_prime(p * q));
+  EXPECT_FALSE(is_probable_prime(p * p));
+
+  for (size_t itn = 0; itn != 200; ++itn) {
+    big_integer x = rand_big(1 + itn % 12) | 1;
+    ASSERT_EQ(gmp_is_prime(x), is_probable_prime(x, 2)) << to_string(x);
+  }
+}
+
+TEST(correctness, next_prime) {
+  EXPECT_EQ(big_integer(2), next_prime(-5));
+  EXPECT_EQ(big_integer(2), next_prime(1));
+  EXPECT_EQ(big_integer(3), next_prime(2));
+  EXPECT_EQ(big_integer(5), next_prime(3));
+  EXPECT_EQ(big_integer(17), next_prime(13));
+  EXPECT_EQ(big_integer(65537), next_prime(65521));
+  EXPECT_EQ(big_integer("1000000000000000003"), next_prime(big_integer("1000000000000000000")));
+  EXPECT_EQ((big_integer(1) << 64) + 13, next_prime(big_integer(1) << 64));
+  for (size_t itn = 0; itn != 30; ++itn) {
+    big_integer x = rand_big(1 + itn % 20);
+    EXPECT_EQ(gmp_next_prime(x), next_prime(x));
+  }
+}
+
+TEST(correctness, gcd) {
+  EXPECT_EQ(0, gcd(0, 0));
+  EXPECT_EQ(7, gcd(0, -7));
+  EXPECT_EQ(6, gcd(-12, 18));
+  EXPECT_EQ(big_integer(1) << 100, gcd(big_integer(3) << 100, big_integer(5) << 120));
+  for (size_t itn = 0; itn != 100; ++itn) {
+    big_integer g = rand_big(1 + itn % 8), a = rand_big(1 + itn % 5) * g, b = rand_big(itn % 13) * g;
+    big_integer x = a, y = b;
+    while (y != 0) {
+      x %= y;
+      swap(x, y);
+    }
+    EXPECT_EQ(x, gcd(a, -b));
+    EXPECT_EQ(0, x % g);
+  }
+  // Consecutive Fibonacci numbers take the most steps, all quotients one.
+  big_integer f = 1, g = 1;
+  for (size_t i = 0; i != 3000; ++i) {
+    f += g;
+    swap(f, g);
+  }
+  EXPECT_EQ(1, gcd(g, f));
+  EXPECT_EQ(f * 2, gcd(f * 4 * g, f * 6));
+}
+
+TEST(correctness, big_rational) {
+  big_rational half(1, 2), third(big_integer(-2), big_integer(-6));
+  EXPECT_EQ("5/6", to_string(half + third));
+  EXPECT_EQ("1/6", to_string(half - third));
+  EXPECT_EQ("1/6", to_string(half * third));
+  EXPECT_EQ("3/2", to_string(half / third));
+  EXPECT_EQ(big_integer(3), third.denominator());
+  EXPECT_EQ(big_rational(-2), -(half * 4));
+  EXPECT_EQ(big_rational("10/20"), half);
+  EXPECT_EQ("-7", to_string(big_rational("-14/2")));
+  EXPECT_EQ("0", to_string(half - half));
+  EXPECT_TRUE(third < half);
+  EXPECT_TRUE(-half < -third);
+  EXPECT_TRUE(big_rational(1, 1000) > big_rational(-1000000));
+  EXPECT_TRUE(big_rational(1, 3) <= big_rational(2, 6));
+  EXPECT_THROW(big_rational(1, 0), std::runtime_error);
+  EXPECT_THROW(half / 0, std::runtime_error);
+
+  std::ostringstream out;
+  out << big_rational(6, -4);
+  EXPECT_EQ("-3/2", out.str());
+
+  // Reading an unreduced fraction leaves it as it is, from any thread.
+  big_integer g = big_integer(3) << 100;
+  big_rational const unreduced(g * 5, g * -7);
+  std::vector<std::thread> readers;
+  for (int i = 0; i != 4; ++i) {
+    readers.emplace_back([&] {
+      EXPECT_EQ(-5, unreduced.numerator());
+      EXPECT_EQ(7, unreduced.denominator());
+      EXPECT_EQ("-5/7", to_string(unreduced));
+    });
+  }
+  for (std::thread& t : readers) {
+    t.join();
+  }
+  big_rational reduced = unreduced;
+  EXPECT_EQ(big_rational(-5, 7), reduced.reduce());
+}
+
+// Sums and products past NORMALIZE_BITS take the reducing paths, the rest
+// stay unreduced; both have to agree with fractions built directly.
+TEST(correctness, big_rational_randomized) {
+  for (size_t itn = 0; itn != 200; ++itn) {
+    size_t size = itn % 2 ? 2 : 80;
+    big_integer a = rand_big(size), b = rand_big(size) + 1, c = rand_big(size), d = rand_big(size) + 1;
+    if (itn % 3 == 0) {
+      a = -a;
+    }
+    big_integer common = rand_big(size / 2);
+    b *= common;
+    d *= common;
+    big_rational x(a, b), y(c, d);
+    if (itn % 4 == 0) {
+      x.reduce();
+      y.reduce();
+    }
+    EXPECT_EQ(big_rational(a * d + c * b, b * d), x + y);
+    EXPECT_EQ(big_rational(a * d - c * b, b * d), x - y);
+    EXPECT_EQ(big_rational(a * c, b * d), x * y);
+    if (c != 0) {
+      EXPECT_EQ(big_rational(a * d, b * c), x / y);
+    }
+    EXPECT_EQ(a * d < c * b, x < y);
+    big_rational sum = x + y;
+    EXPECT_EQ(1, gcd(sum.numerator(), sum.denominator()));
+    EXPECT_GT(sum.denominator(), 0);
+  }
+}
+
+TEST(correctness, big_decimal) {
+  big_decimal price("19.99"), rate("0.0825");
+  EXPECT_EQ("1.649175", to_string(price * rate));
+  EXPECT_EQ("21.639175", to_string(price + price * rate));
+  EXPECT_EQ("-0.0025", to_string(rate - big_decimal("0.085")));
+  EXPECT_EQ("0.05", to_string(big_decimal(5, 2)));
+  EXPECT_EQ("-0.050", to_string(big_decimal(-50, 3)));
+  EXPECT_EQ("-0.5", to_string(big_decimal("-.5")));
+  EXPECT_EQ("12", to_string(big_decimal("+12")));
+  EXPECT_EQ(big_decimal("1.50"), big_decimal("1.5"));
+  EXPECT_TRUE(big_decimal("-1.05") < big_decimal("-1.0"));
+  EXPECT_TRUE(big_decimal("2") > big_decimal("1.999999999999999999999999999999999"));
+  EXPECT_EQ("1.500", to_string(big_decimal("1.5").rescale(3)));
+  EXPECT_THROW(big_decimal(""), std::runtime_error);
+  EXPECT_THROW(big_decimal("1.2.3"), std::runtime_error);
+  EXPECT_THROW(big_decimal("-"), std::runtime_error);
+  EXPECT_THROW(big_decimal("1e5"), std::runtime_error);
+  EXPECT_THROW(divide(price, big_decimal("0.00"), 2), std::runtime_error);
+
+  // The table of RoundingMode in the Java documentation.
+  char const* inputs[] = {"5.5", "2.5", "1.6", "1.1", "1.0", "-1.0", "-1.1", "-1.6", "-2.5", "-5.5"};
+  std::pair<rounding_mode, std::vector<int>> expected[] = {
+      {rounding_mode::up, {6, 3, 2, 2, 1, -1, -2, -2, -3, -6}},
+      {rounding_mode::down, {5, 2, 1, 1, 1, -1, -1, -1, -2, -5}},
+      {rounding_mode::ceiling, {6, 3, 2, 2, 1, -1, -1, -1, -2, -5}},
+      {rounding_mode::floor, {5, 2, 1, 1, 1, -1, -2, -2, -3, -6}},
+      {rounding_mode::half_up, {6, 3, 2, 1, 1, -1, -1, -2, -3, -6}},
+      {rounding_mode::half_down, {5, 2, 2, 1, 1, -1, -1, -2, -2, -5}},
+      {rounding_mode::half_even, {6, 2, 2, 1, 1, -1, -1, -2, -2, -6}},
+  };
+  for (auto const& row : expected) {
+    for (size_t i = 0; i != 10; ++i) {
+      EXPECT_EQ(big_decimal(row.second[i]), big_decimal(inputs[i]).rescale(0, row.first));
+      EXPECT_EQ(big_decimal(row.second[i]), divide(big_decimal(inputs[i]), big_decimal(1), 0, row.first));
+      EXPECT_EQ(divide(-big_decimal(inputs[i]), big_decimal(1), 0, row.first),
+                divide(big_decimal(inputs[i]), big_decimal(-1), 0, row.first));
+    }
+  }
+
+  EXPECT_EQ("0.333333333333333333333333333333", to_string(divide(big_decimal(1), big_decimal(3), 30)));
+  EXPECT_EQ("-0.666666666666666666666666666667", to_string(divide(big_decimal(-2), big_decimal(3), 30)));
+  EXPECT_EQ("3", to_string(divide(big_decimal("12.345"), big_decimal("4.1"), 0)));
+  EXPECT_EQ("123", to_string(divide(big_decimal("12.345"), big_decimal("0.1"), 0, rounding_mode::down)));
+  EXPECT_EQ("124", to_string(divide(big_decimal("12.345"), big_decimal("0.1"), 0, rounding_mode::up)));
+}
+
+TEST(correctness, big_decimal_randomized) {
+  for (size_t itn = 0; itn != 300; ++itn) {
+    size_t size = itn % 2 ? 1 : 6;
+    big_decimal a(rand_big(size) * (itn % 3 == 0 ? -1 : 1), itn % 40), b(rand_big(size) + 1, itn % 7 * 5);
+    if (itn % 5 == 0) {
+      b = -b;
+    }
+    size_t scale = itn % 11 * 4;
+    auto exact = [](big_decimal const& x) {
+      return big_rational(x.mantissa(), big_decimal::power_of_ten(x.scale()).value());
+    };
+    big_rational quotient = exact(a) / exact(b), ulp(1, big_decimal::power_of_ten(scale).value());
+    decimal_divisor prepared(b);
+    big_decimal low = divide(a, prepared, scale, rounding_mode::floor);
+    big_decimal high = divide(a, b, scale, rounding_mode::ceiling);
+    EXPECT_EQ(scale, low.scale());
+    EXPECT_TRUE(exact(low) <= quotient && quotient < exact(low) + ulp);
+    EXPECT_TRUE(exact(high) >= quotient && quotient > exact(high) - ulp);
+    big_decimal nearest = divide(a, prepared, scale);
+    EXPECT_TRUE(nearest == low || nearest == high);
+    EXPECT_TRUE(big_rational(2) * (exact(nearest) - quotient) <= ulp);
+    EXPECT_TRUE(big_rational(-2) * (exact(nearest) - quotient) <= ulp);
+
+    big_decimal rounded = a;
+    rounded.rescale(scale / 2, rounding_mode::half_up);
+    EXPECT_EQ(divide(a, big_decimal(1), scale / 2, rounding_mode::half_up), rounded);
+    EXPECT_EQ(a, big_decimal(a).rescale(a.scale() + scale));
+    EXPECT_EQ(exact(a) + exact(b), exact(a + b));
+    EXPECT_EQ(exact(a) * exact(b), exact(a * b));
+    EXPECT_EQ(exact(a) < exact(b), a < b);
+    EXPECT_EQ(a, big_decimal(to_string(a)));
+  }
+}
+
 // y2019 tests
 
 TEST(correctness_random, cmp) {
@@ -835,3 +2045,37 @@ TEST(correctness_twos_complement, all_ones) {
 
   EXPECT_EQ(to_string(gmp_ans), to_string(your_ans));
 }
+
+TEST(correctness_twos_complement, zero_low_limbs) {
+  std::string a = "56319";
+  std::string b = "-68719476736"; // -(1 << 36)
+
+  big_integer_gmp gmp_a(a), gmp_b(b);
+  big_integer your_a(a), your_b(b);
+
+  EXPECT_EQ(to_string(gmp_a | gmp_b), to_string(your_a | your_b));
+  EXPECT_EQ(to_string(gmp_b & gmp_a), to_string(your_b & your_a));
+  EXPECT_EQ(to_string(gmp_a ^ gmp_b), to_string(your_a ^ your_b));
+}
+
+TEST(correctness_twos_complement, carry_out) {
+  std::string a = "-2147483648"; // -(1 << 31)
+  std::string b = "-2147483649"; // -((1 << 31) + 1)
+
+  big_integer_gmp gmp_a(a), gmp_b(b);
+  big_integer your_a(a), your_b(b);
+
+  EXPECT_EQ(to_string(gmp_a & gmp_b), to_string(your_a & your_b));
+}
+
+TEST(correctness_twos_complement, shr_rounds_down) {
+  for (int a : {-1, -2, -4, -5, -256, -257}) {
+    for (int shift : {0, 1, 2, 8, 31, 32, 40}) {
+      EXPECT_EQ(to_string(big_integer_gmp(a) >> shift), to_string(big_integer(a) >> shift));
+    }
+  }
+  big_integer a = -(big_integer(1) << 96);
+  EXPECT_EQ(-(big_integer(1) << 32), a >> 64);
+  EXPECT_EQ(-1, a >> 97);
+  EXPECT_EQ(-1, (a - 1) >> 200);
+}
@@ -0,0 +1,99 @@
+#include "big_integer_view.h"
+#include "limb_kernels.h"
+
+#include <stdexcept>
+
+big_integer_view::big_integer_view(uint32_t const* limbs, size_t size, bool negative)
+	: limbs_(limbs), size_(limbs::normalized_size(limbs, size)), negative_(negative && size_ != 0) {}
+
+big_integer_view big_integer_view::from_record(byte_span in, size_t& used) {
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	throw std::runtime_error("big_integer_view needs a little-endian host");
+#endif
+	if (reinterpret_cast<uintptr_t>(in.data) % alignof(uint32_t) != 0) {
+		throw std::runtime_error("Misaligned big_integer record");
+	}
+	if (in.size < SERIALIZED_HEADER_SZ) {
+		throw std::runtime_error("Truncated big_integer record");
+	}
+	uint64_t header = 0;
+	for (size_t i = 0; i < SERIALIZED_HEADER_SZ; i++) {
+		header |= static_cast<uint64_t>(in.data[i]) << (8 * i);
+	}
+	uint64_t count = header >> 1u;
+	if (count > (in.size - SERIALIZED_HEADER_SZ) / sizeof(uint32_t)) {
+		throw std::runtime_error("Truncated big_integer record");
+	}
+	used = SERIALIZED_HEADER_SZ + static_cast<size_t>(count) * sizeof(uint32_t);
+	return big_integer_view(reinterpret_cast<uint32_t const*>(in.data + SERIALIZED_HEADER_SZ),
+	                        static_cast<size_t>(count), header & 1u);
+}
+
+big_integer_view big_integer_view::from_record(byte_span in) {
+	size_t used;
+	return from_record(in, used);
+}
+
+big_integer operator+(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) + big_integer(b);
+}
+
+big_integer operator-(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) - big_integer(b);
+}
+
+big_integer operator*(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) * big_integer(b);
+}
+
+big_integer operator/(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) / big_integer(b);
+}
+
+big_integer operator%(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) % big_integer(b);
+}
+
+big_integer operator&(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) & big_integer(b);
+}
+
+big_integer operator|(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) | big_integer(b);
+}
+
+big_integer operator^(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) ^ big_integer(b);
+}
+
+bool operator==(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) == big_integer(b);
+}
+
+bool operator!=(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) != big_integer(b);
+}
+
+bool operator<(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) < big_integer(b);
+}
+
+bool operator>(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) > big_integer(b);
+}
+
+bool operator<=(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) <= big_integer(b);
+}
+
+bool operator>=(big_integer_view const& a, big_integer_view const& b) {
+	return big_integer(a) >= big_integer(b);
+}
+
+uint64_t hash_value(big_integer_view const& a, uint64_t seed) {
+	return hash_value(big_integer(a), seed);
+}
+
+uint64_t hash_value(big_integer_view const& a) {
+	return hash_value(big_integer(a));
+}
@@ -0,0 +1,74 @@
+#ifndef BIGINT_BIG_INTEGER_VIEW_H
+#define BIGINT_BIG_INTEGER_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "big_integer.h"
+#include "serialization.h"
+
+// Read-only value whose limbs live somewhere else, typically in a record of
+// a memory-mapped file. Converting it to big_integer does not copy the
+// limbs: the big_integer borrows them and copies them only on its first
+// write. The limbs must outlive the view and every big_integer that still
+// borrows them.
+class big_integer_view {
+public:
+	big_integer_view() = default;
+	big_integer_view(uint32_t const* limbs, size_t size, bool negative);
+
+	// View of the binary record at the front of in, which must start at a
+	// multiple of four bytes. Sets used to the size of the record.
+	static big_integer_view from_record(byte_span in, size_t& used);
+	static big_integer_view from_record(byte_span in);
+
+	uint32_t const* limbs() const {
+		return limbs_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	bool negative() const {
+		return negative_;
+	}
+
+private:
+	uint32_t const* limbs_ = nullptr;
+	size_t size_ = 0;
+	bool negative_ = false;
+};
+
+// Mixed view and big_integer operands resolve to the big_integer operators;
+// these cover the case of two views.
+big_integer operator+(big_integer_view const& a, big_integer_view const& b);
+big_integer operator-(big_integer_view const& a, big_integer_view const& b);
+big_integer operator*(big_integer_view const& a, big_integer_view const& b);
+big_integer operator/(big_integer_view const& a, big_integer_view const& b);
+big_integer operator%(big_integer_view const& a, big_integer_view const& b);
+
+big_integer operator&(big_integer_view const& a, big_integer_view const& b);
+big_integer operator|(big_integer_view const& a, big_integer_view const& b);
+big_integer operator^(big_integer_view const& a, big_integer_view const& b);
+
+bool operator==(big_integer_view const& a, big_integer_view const& b);
+bool operator!=(big_integer_view const& a, big_integer_view const& b);
+bool operator<(big_integer_view const& a, big_integer_view const& b);
+bool operator>(big_integer_view const& a, big_integer_view const& b);
+bool operator<=(big_integer_view const& a, big_integer_view const& b);
+bool operator>=(big_integer_view const& a, big_integer_view const& b);
+
+// Same values as for the equal big_integer.
+uint64_t hash_value(big_integer_view const& a, uint64_t seed);
+uint64_t hash_value(big_integer_view const& a);
+
+namespace std {
+template<>
+struct hash<big_integer_view> {
+	size_t operator()(big_integer_view const& a) const {
+		return static_cast<size_t>(hash_value(a));
+	}
+};
+}
+#endif //BIGINT_BIG_INTEGER_VIEW_H
@@ -0,0 +1,238 @@
+#include "big_rational.h"
+#include "number_theory.h"
+
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+int sign(big_integer const& a) {
+	return a < 0 ? -1 : a == 0 ? 0 : 1;
+}
+
+// The GCDs are mostly one, which needs no division at all.
+big_integer exact_divide(big_integer const& a, big_integer const& b) {
+	return b == 1 ? a : a / b;
+}
+}
+
+big_rational::big_rational() : num_(0), den_(1), reduced_(true) {}
+
+big_rational::big_rational(int a) : num_(a), den_(1), reduced_(true) {}
+
+big_rational::big_rational(big_integer const& a) : num_(a), den_(1), reduced_(true) {}
+
+big_rational::big_rational(big_integer const& numerator, big_integer const& denominator)
+	: num_(numerator), den_(denominator), reduced_(false) {
+	if (den_ == 0) {
+		throw std::runtime_error("Division by zero");
+	}
+	if (den_ < 0) {
+		num_ = -num_;
+		den_ = -den_;
+	}
+	if (num_ == 0) {
+		den_ = 1;
+	}
+	// Fractions of words, 1/i and the like, are reduced right away; later
+	// operations can only take the cheaper paths for reduced operands.
+	reduced_ = den_ == 1 || abs(num_) == 1;
+	if (!reduced_ && num_.bit_length() <= 64 && den_.bit_length() <= 64) {
+		reduce();
+	}
+}
+
+big_rational::big_rational(std::string const& str) : big_rational() {
+	size_t slash = str.find('/');
+	if (slash == std::string::npos) {
+		*this = big_rational(big_integer(str));
+	} else {
+		*this = big_rational(big_integer(str.substr(0, slash)), big_integer(str.substr(slash + 1)));
+	}
+}
+
+big_rational& big_rational::reduce() {
+	if (!reduced_) {
+		big_integer g = gcd(num_, den_);
+		num_ = exact_divide(num_, g);
+		den_ = exact_divide(den_, g);
+		reduced_ = true;
+	}
+	return *this;
+}
+
+big_rational big_rational::reduced() const {
+	big_rational result(*this);
+	return result.reduce();
+}
+
+void big_rational::normalize_if_large() {
+	if (num_ == 0) {
+		den_ = 1;
+		reduced_ = true;
+	} else if (!reduced_ && den_.bit_length() > NORMALIZE_BITS) {
+		reduce();
+	}
+}
+
+big_integer big_rational::numerator() const {
+	return reduced_ ? num_ : reduced().num_;
+}
+
+big_integer big_rational::denominator() const {
+	return reduced_ ? den_ : reduced().den_;
+}
+
+// With d1 = gcd(b, d), a/b + c/d has the numerator t = a (d / d1) + c (b / d1)
+// and every common factor of t and the denominator divides d1 as well.
+void big_rational::add(big_rational const& rhs, bool subtract) {
+	big_integer c = subtract ? -rhs.num_ : rhs.num_;
+	if (den_ == rhs.den_) {
+		num_ += c;
+		reduced_ = den_ == 1;
+	} else if (reduced_ && rhs.reduced_ && den_.bit_length() + rhs.den_.bit_length() > NORMALIZE_BITS) {
+		big_integer d1 = gcd(den_, rhs.den_);
+		big_integer b = exact_divide(den_, d1), d = exact_divide(rhs.den_, d1);
+		big_integer t = num_ * d + c * b;
+		big_integer d2 = gcd(t, d1);
+		num_ = exact_divide(t, d2);
+		den_ = b * exact_divide(rhs.den_, d2);
+	} else {
+		// An integer plus a reduced fraction stays reduced.
+		bool reduced = (den_ == 1 && rhs.reduced_) || (rhs.den_ == 1 && reduced_);
+		big_integer t = num_ * rhs.den_ + c * den_;
+		den_ *= rhs.den_;
+		num_ = t;
+		reduced_ = reduced;
+	}
+	normalize_if_large();
+}
+
+big_rational& big_rational::operator+=(big_rational const& rhs) {
+	add(rhs, false);
+	return *this;
+}
+
+big_rational& big_rational::operator-=(big_rational const& rhs) {
+	add(rhs, true);
+	return *this;
+}
+
+// Cancels across, a/b * c/d = (a/g1 * c/g2) / (b/g2 * d/g1) with
+// g1 = gcd(a, d) and g2 = gcd(c, b), which is reduced when both were.
+big_rational& big_rational::operator*=(big_rational const& rhs) {
+	if (reduced_ && rhs.reduced_ && den_.bit_length() + rhs.den_.bit_length() > NORMALIZE_BITS) {
+		big_integer g1 = gcd(num_, rhs.den_), g2 = gcd(rhs.num_, den_);
+		big_integer num = exact_divide(num_, g1) * exact_divide(rhs.num_, g2);
+		den_ = exact_divide(den_, g2) * exact_divide(rhs.den_, g1);
+		num_ = num;
+	} else {
+		reduced_ = reduced_ && rhs.reduced_ && den_ == 1 && rhs.den_ == 1;
+		num_ *= rhs.num_;
+		den_ *= rhs.den_;
+	}
+	normalize_if_large();
+	return *this;
+}
+
+big_rational& big_rational::operator/=(big_rational const& rhs) {
+	if (rhs.num_ == 0) {
+		throw std::runtime_error("Division by zero");
+	}
+	big_rational inverse;
+	inverse.num_ = rhs.num_ < 0 ? -rhs.den_ : rhs.den_;
+	inverse.den_ = abs(rhs.num_);
+	inverse.reduced_ = rhs.reduced_;
+	return *this *= inverse;
+}
+
+big_rational big_rational::operator+() const {
+	return *this;
+}
+
+big_rational big_rational::operator-() const {
+	big_rational result(*this);
+	result.num_ = -result.num_;
+	return result;
+}
+
+big_rational operator+(big_rational a, big_rational const& b) {
+	return a += b;
+}
+
+big_rational operator-(big_rational a, big_rational const& b) {
+	return a -= b;
+}
+
+big_rational operator*(big_rational a, big_rational const& b) {
+	return a *= b;
+}
+
+big_rational operator/(big_rational a, big_rational const& b) {
+	return a /= b;
+}
+
+// A nonzero n/d lies in [2^(e-1), 2^(e+1)) for e = bit_length(n) -
+// bit_length(d), so values whose e differ by two or more are told apart
+// without multiplying.
+int big_rational::compare(big_rational const& a, big_rational const& b) {
+	int sa = sign(a.num_), sb = sign(b.num_);
+	if (sa != sb) {
+		return sa < sb ? -1 : 1;
+	}
+	if (sa == 0) {
+		return 0;
+	}
+	if (a.den_ == b.den_) {
+		return a.num_ < b.num_ ? -1 : a.num_ == b.num_ ? 0 : 1;
+	}
+	auto exponent = [](big_rational const& x) {
+		return static_cast<long long>(x.num_.bit_length()) - static_cast<long long>(x.den_.bit_length());
+	};
+	long long ea = exponent(a), eb = exponent(b);
+	if (ea + 2 <= eb) {
+		return -sa;
+	}
+	if (eb + 2 <= ea) {
+		return sa;
+	}
+	big_integer left = a.num_ * b.den_, right = b.num_ * a.den_;
+	return left < right ? -1 : left == right ? 0 : 1;
+}
+
+bool operator==(big_rational const& a, big_rational const& b) {
+	if (a.reduced_ && b.reduced_) {
+		return a.num_ == b.num_ && a.den_ == b.den_;
+	}
+	return big_rational::compare(a, b) == 0;
+}
+
+bool operator!=(big_rational const& a, big_rational const& b) {
+	return !(a == b);
+}
+
+bool operator<(big_rational const& a, big_rational const& b) {
+	return big_rational::compare(a, b) < 0;
+}
+
+bool operator>(big_rational const& a, big_rational const& b) {
+	return big_rational::compare(a, b) > 0;
+}
+
+bool operator<=(big_rational const& a, big_rational const& b) {
+	return big_rational::compare(a, b) <= 0;
+}
+
+bool operator>=(big_rational const& a, big_rational const& b) {
+	return big_rational::compare(a, b) >= 0;
+}
+
+std::string to_string(big_rational const& a) {
+	if (!a.reduced_) {
+		return to_string(a.reduced());
+	}
+	return a.den_ == 1 ? to_string(a.num_) : to_string(a.num_) + "/" + to_string(a.den_);
+}
+
+std::ostream& operator<<(std::ostream& s, big_rational const& a) {
+	return s << to_string(a);
+}
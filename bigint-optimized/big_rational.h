@@ -0,0 +1,86 @@
+#ifndef BIGINT_BIG_RATIONAL_H
+#define BIGINT_BIG_RATIONAL_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include "big_integer.h"
+
+// Exact fraction of two big_integers. The denominator is always positive
+// and carries no sign, but the fraction is only reduced to lowest terms by
+// reduce() or once the denominator grows past NORMALIZE_BITS; arithmetic
+// in between works on the unreduced terms and skips the GCDs.
+//
+// Once reduction is due, + and * take the terms from the reduced operands
+// the way Knuth describes in TAOCP 4.5.1: the GCDs are taken of the
+// operands' terms, which are half the size of the products. Comparisons
+// look at the bit lengths first and cross-multiply otherwise, they never
+// reduce. Const members never write, so concurrent reads are safe; on an
+// unreduced fraction numerator(), denominator() and to_string() reduce a
+// copy each time, call reduce() first when reading repeatedly.
+class big_rational {
+public:
+	// Denominators of up to this many bits are left unreduced.
+	static constexpr size_t NORMALIZE_BITS = 2048;
+
+	big_rational();
+	big_rational(int a);
+	big_rational(big_integer const& a);
+	// Throws std::runtime_error for a zero denominator.
+	big_rational(big_integer const& numerator, big_integer const& denominator);
+	// "a" or "a/b" with a and b in decimal. Throws std::runtime_error for
+	// malformed input and for b = 0.
+	explicit big_rational(std::string const& str);
+
+	// Reduces to lowest terms in place.
+	big_rational& reduce();
+
+	// The terms in lowest terms.
+	big_integer numerator() const;
+	big_integer denominator() const;
+
+	big_rational& operator+=(big_rational const& rhs);
+	big_rational& operator-=(big_rational const& rhs);
+	big_rational& operator*=(big_rational const& rhs);
+	// Throws std::runtime_error for a zero divisor.
+	big_rational& operator/=(big_rational const& rhs);
+
+	big_rational operator+() const;
+	big_rational operator-() const;
+
+	friend bool operator==(big_rational const& a, big_rational const& b);
+	friend bool operator!=(big_rational const& a, big_rational const& b);
+	friend bool operator<(big_rational const& a, big_rational const& b);
+	friend bool operator>(big_rational const& a, big_rational const& b);
+	friend bool operator<=(big_rational const& a, big_rational const& b);
+	friend bool operator>=(big_rational const& a, big_rational const& b);
+
+	friend std::string to_string(big_rational const& a);
+
+private:
+	big_integer num_;
+	big_integer den_;
+	bool reduced_;
+
+	big_rational reduced() const;
+	void normalize_if_large();
+	void add(big_rational const& rhs, bool subtract);
+	static int compare(big_rational const& a, big_rational const& b);
+};
+
+big_rational operator+(big_rational a, big_rational const& b);
+big_rational operator-(big_rational a, big_rational const& b);
+big_rational operator*(big_rational a, big_rational const& b);
+big_rational operator/(big_rational a, big_rational const& b);
+
+bool operator==(big_rational const& a, big_rational const& b);
+bool operator!=(big_rational const& a, big_rational const& b);
+bool operator<(big_rational const& a, big_rational const& b);
+bool operator>(big_rational const& a, big_rational const& b);
+bool operator<=(big_rational const& a, big_rational const& b);
+bool operator>=(big_rational const& a, big_rational const& b);
+
+std::string to_string(big_rational const& a);
+std::ostream& operator<<(std::ostream& s, big_rational const& a);
+
+#endif //BIGINT_BIG_RATIONAL_H
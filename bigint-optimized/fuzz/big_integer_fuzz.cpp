@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "big_integer.h"
+#include "big_integer_gmp.h"
+
+// Differential fuzz target. The input is a program over four registers,
+// each holding the same value as a big_integer and as a big_integer_gmp;
+// every instruction runs on both and the results are compared. A mismatch
+// aborts, which libFuzzer and AFL record as a crash.
+//
+// The two sides are also timed, and an instruction that takes more than
+// BIGINT_FUZZ_MAX_RATIO (100) times as long as GMP, and more than
+// BIGINT_FUZZ_MIN_NS (1000000) nanoseconds, aborts as well. That keeps the
+// inputs that hit slow paths: worst-case quotient corrections, quadratic
+// conversions and the like. A ratio of 0 turns the check off.
+
+namespace {
+size_t const REGISTERS = 4;
+// Values are kept below this many bits so that one input stays fast.
+size_t const MAX_BITS = size_t(1) << 20u;
+
+struct value {
+	big_integer mine;
+	big_integer_gmp gmp;
+};
+
+class reader {
+public:
+	reader(uint8_t const* data, size_t size) : data_(data), size_(size) {}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	uint8_t byte() {
+		if (size_ == 0) {
+			return 0;
+		}
+		size_--;
+		return *data_++;
+	}
+
+	uint16_t word() {
+		uint16_t low = byte();
+		return static_cast<uint16_t>(low | (byte() << 8u));
+	}
+
+	value& reg(value* regs) {
+		return regs[byte() % REGISTERS];
+	}
+
+private:
+	uint8_t const* data_;
+	size_t size_;
+};
+
+double env_or(char const* name, double fallback) {
+	char const* s = std::getenv(name);
+	return s ? std::atof(s) : fallback;
+}
+
+double const MAX_RATIO = env_or("BIGINT_FUZZ_MAX_RATIO", 100);
+double const MIN_NS = env_or("BIGINT_FUZZ_MIN_NS", 1e6);
+
+[[noreturn]] void fail(char const* op, std::string const& message) {
+	std::fprintf(stderr, "%s: %s\n", op, message.c_str());
+	std::abort();
+}
+
+void compare(char const* op, value const& v) {
+	std::string mine = to_string(v.mine), gmp = to_string(v.gmp);
+	if (mine != gmp) {
+		fail(op, "big_integer gives " + mine + ", GMP gives " + gmp);
+	}
+}
+
+template<typename F>
+double time_ns(F&& f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs mine and gmp and checks the time ratio; bits is the operand length
+// reported with a slow instruction. Both have to be repeatable, a slow
+// first run is timed twice more to rule out a preemption or a page fault.
+template<typename F, typename G>
+void run(char const* op, size_t bits, F&& mine, G&& gmp) {
+	double mine_ns = time_ns(mine);
+	double gmp_ns = time_ns(gmp);
+	for (int retry = 0; retry < 2 && MAX_RATIO > 0 && mine_ns > MIN_NS && mine_ns > MAX_RATIO * gmp_ns; retry++) {
+		mine_ns = std::min(mine_ns, time_ns(mine));
+		gmp_ns = std::min(gmp_ns, time_ns(gmp));
+	}
+	if (MAX_RATIO > 0 && mine_ns > MIN_NS && mine_ns > MAX_RATIO * gmp_ns) {
+		fail(op, "slow on " + std::to_string(bits) + "-bit operands: " + std::to_string(mine_ns) +
+		         " ns against " + std::to_string(gmp_ns) + " ns for GMP");
+	}
+}
+
+size_t bits(value const& v) {
+	return v.mine.bit_length();
+}
+
+void load(reader& in, value& dst) {
+	bool negative = in.byte() & 1u;
+	size_t length = in.byte();
+	big_integer mine;
+	big_integer_gmp gmp;
+	for (size_t i = 0; i < length; i++) {
+		int digit = in.byte();
+		mine = (mine << 8) + digit;
+		gmp = (gmp << 8) + big_integer_gmp(digit);
+	}
+	dst.mine = negative ? -mine : mine;
+	dst.gmp = negative ? -gmp : gmp;
+}
+
+// Executes one instruction, skipping those whose result would be too long.
+void step(reader& in, value* regs) {
+	uint8_t code = in.byte() % 18;
+	if (code == 0) {
+		load(in, in.reg(regs));
+		return;
+	}
+	value& dst = in.reg(regs);
+	value const a = in.reg(regs);
+	value const b = in.reg(regs);
+	size_t size = std::max(bits(a), bits(b));
+	switch (code) {
+	case 1:
+		run("add", size, [&] { dst.mine = a.mine + b.mine; }, [&] { dst.gmp = a.gmp + b.gmp; });
+		compare("add", dst);
+		break;
+	case 2:
+		run("sub", size, [&] { dst.mine = a.mine - b.mine; }, [&] { dst.gmp = a.gmp - b.gmp; });
+		compare("sub", dst);
+		break;
+	case 3:
+		if (bits(a) + bits(b) <= MAX_BITS) {
+			run("mul", size, [&] { dst.mine = a.mine * b.mine; }, [&] { dst.gmp = a.gmp * b.gmp; });
+			compare("mul", dst);
+		}
+		break;
+	case 4:
+	case 5: {
+		char const* op = code == 4 ? "div" : "mod";
+		if (b.mine == 0) {
+			try {
+				dst.mine = code == 4 ? a.mine / b.mine : a.mine % b.mine;
+			} catch (std::runtime_error const&) {
+				break;
+			}
+			fail(op, "division by zero did not throw");
+		}
+		if (code == 4) {
+			run(op, size, [&] { dst.mine = a.mine / b.mine; }, [&] { dst.gmp = a.gmp / b.gmp; });
+		} else {
+			run(op, size, [&] { dst.mine = a.mine % b.mine; }, [&] { dst.gmp = a.gmp % b.gmp; });
+		}
+		compare(op, dst);
+		break;
+	}
+	case 6:
+		run("and", size, [&] { dst.mine = a.mine & b.mine; }, [&] { dst.gmp = a.gmp & b.gmp; });
+		compare("and", dst);
+		break;
+	case 7:
+		run("or", size, [&] { dst.mine = a.mine | b.mine; }, [&] { dst.gmp = a.gmp | b.gmp; });
+		compare("or", dst);
+		break;
+	case 8:
+		run("xor", size, [&] { dst.mine = a.mine ^ b.mine; }, [&] { dst.gmp = a.gmp ^ b.gmp; });
+		compare("xor", dst);
+		break;
+	case 9:
+	case 10: {
+		int shift = in.word();
+		if (code == 9 && bits(a) + shift <= MAX_BITS) {
+			run("shl", bits(a), [&] { dst.mine = a.mine << shift; }, [&] { dst.gmp = a.gmp << shift; });
+			compare("shl", dst);
+		} else if (code == 10) {
+			run("shr", bits(a), [&] { dst.mine = a.mine >> shift; }, [&] { dst.gmp = a.gmp >> shift; });
+			compare("shr", dst);
+		}
+		break;
+	}
+	case 11:
+		run("neg", bits(a), [&] { dst.mine = -a.mine; }, [&] { dst.gmp = -a.gmp; });
+		compare("neg", dst);
+		break;
+	case 12:
+		run("not", bits(a), [&] { dst.mine = ~a.mine; }, [&] { dst.gmp = ~a.gmp; });
+		compare("not", dst);
+		break;
+	case 13: {
+		std::string mine, gmp;
+		run("to_string", bits(a), [&] { mine = to_string(a.mine); }, [&] { gmp = to_string(a.gmp); });
+		if (mine != gmp) {
+			fail("to_string", "big_integer gives " + mine + ", GMP gives " + gmp);
+		}
+		run("parse", bits(a), [&] { dst.mine = big_integer(mine); }, [&] { dst.gmp = big_integer_gmp(gmp); });
+		compare("parse", dst);
+		break;
+	}
+	case 14: {
+		bool mine = false, gmp = false;
+		run("compare", size, [&] { mine = a.mine < b.mine; }, [&] { gmp = a.gmp < b.gmp; });
+		if (mine != gmp || (a.mine == b.mine) != (a.gmp == b.gmp)) {
+			fail("compare", to_string(a.mine) + " against " + to_string(b.mine));
+		}
+		break;
+	}
+	case 15:
+	case 16:
+	case 17: {
+		int small = static_cast<int16_t>(in.word());
+		if (code == 15) {
+			run("add_int", bits(a), [&] { dst.mine = a.mine + small; }, [&] { dst.gmp = a.gmp + big_integer_gmp(small); });
+			compare("add_int", dst);
+		} else if (code == 16) {
+			run("mul_int", bits(a), [&] { dst.mine = a.mine * small; }, [&] { dst.gmp = a.gmp * big_integer_gmp(small); });
+			compare("mul_int", dst);
+		} else if (small != 0) {
+			run("div_int", bits(a), [&] { dst.mine = a.mine / small; }, [&] { dst.gmp = a.gmp / big_integer_gmp(small); });
+			compare("div_int", dst);
+		}
+		break;
+	}
+	}
+}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+	value regs[REGISTERS];
+	reader in(data, size);
+	while (!in.empty()) {
+		step(in, regs);
+	}
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Driver for compilers without libFuzzer. With file arguments each file is
+// run once, which replays a corpus or a saved crash; with no arguments the
+// input is read from standard input, the way AFL runs a target; with
+// --runs=<n> it runs n random inputs of up to --max_len=<bytes, 256>
+// from --seed=<0>. An input that crashes or aborts is written to
+// crash-input in the working directory, to be replayed as a file.
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+namespace {
+bool starts_with(char const* arg, char const* prefix, char const*& value) {
+	size_t n = std::strlen(prefix);
+	if (std::strncmp(arg, prefix, n) != 0) {
+		return false;
+	}
+	value = arg + n;
+	return true;
+}
+
+std::vector<uint8_t> const* current = nullptr;
+
+// Only async-signal-safe calls, then the default action of the signal.
+extern "C" void save_input(int signal) {
+	int fd = open("crash-input", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd >= 0) {
+		if (current != nullptr) {
+			ssize_t written = write(fd, current->data(), current->size());
+			char const message[] = "input written to crash-input\n";
+			written = write(STDERR_FILENO, message, sizeof(message) - 1);
+			static_cast<void>(written);
+		}
+		close(fd);
+	}
+	std::signal(signal, SIG_DFL);
+	std::raise(signal);
+}
+
+void run(std::vector<uint8_t> const& input) {
+	current = &input;
+	LLVMFuzzerTestOneInput(input.data(), input.size());
+	current = nullptr;
+}
+}
+
+int main(int argc, char** argv) {
+	size_t runs = 0, max_len = 256;
+	unsigned long seed = 0;
+	std::vector<char const*> files;
+	for (int signal : {SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL}) {
+		std::signal(signal, save_input);
+	}
+	for (int i = 1; i < argc; i++) {
+		char const* value = nullptr;
+		if (starts_with(argv[i], "--runs=", value)) {
+			runs = static_cast<size_t>(std::atoll(value));
+		} else if (starts_with(argv[i], "--max_len=", value)) {
+			max_len = static_cast<size_t>(std::atoll(value));
+		} else if (starts_with(argv[i], "--seed=", value)) {
+			seed = std::strtoul(value, nullptr, 10);
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	for (char const* name : files) {
+		std::ifstream in(name, std::ios::binary);
+		if (!in) {
+			std::fprintf(stderr, "cannot open %s\n", name);
+			return 1;
+		}
+		run(std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+	}
+	if (runs != 0) {
+		std::mt19937 rng(seed);
+		std::vector<uint8_t> input;
+		for (size_t i = 0; i < runs; i++) {
+			input.resize(rng() % (max_len + 1));
+			for (uint8_t& byte : input) {
+				byte = static_cast<uint8_t>(rng());
+			}
+			run(input);
+		}
+		std::fprintf(stderr, "%zu runs passed\n", runs);
+	} else if (files.empty()) {
+		run(std::vector<uint8_t>(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()));
+	}
+	return 0;
+}
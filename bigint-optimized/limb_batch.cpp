@@ -0,0 +1,134 @@
+#include "limb_batch.h"
+#include "scratch_arena.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// The kernels are built for AVX-512 and AVX2 next to the baseline, the
+// loader picks the best one the CPU supports. Every inner loop runs across
+// the lanes of a block, so it maps onto vector adds, compares and 32x32->64
+// multiplies with one carry per lane.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define BATCH_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define BATCH_KERNEL
+#endif
+
+namespace {
+size_t const LANES = 16;
+// Multiplication walks the rows of a block an * bn times; wider blocks
+// amortize the per-row overhead better.
+size_t const MUL_LANES = 64;
+
+// A block is LANES numbers, or the remaining ones at the end of the batch.
+// For full blocks the width is a constant, so the lane loops unroll into
+// whole vectors and the carries stay in registers. A row of sums is built
+// locally and stored after the whole row is read, so r may alias a or b.
+template<bool Full>
+inline void add_block(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n, size_t count,
+                      uint32_t* carry_out, size_t width) {
+	size_t const w = Full ? LANES : width;
+	uint64_t carry[LANES] = {};
+	for (size_t i = 0; i < n; i++) {
+		size_t row = i * count;
+		uint32_t total[LANES];
+		for (size_t k = 0; k < w; k++) {
+			uint64_t t = static_cast<uint64_t>(a[row + k]) + b[row + k] + carry[k];
+			total[k] = static_cast<uint32_t>(t);
+			carry[k] = t >> 32u;
+		}
+		std::copy_n(total, w, r + row);
+	}
+	for (size_t k = 0; k < w; k++) {
+		carry_out[k] = static_cast<uint32_t>(carry[k]);
+	}
+}
+
+inline void mul_block(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t count,
+                      size_t width) {
+	for (size_t i = 0; i < an; i++) {
+		std::fill_n(r + i * count, width, 0);
+	}
+	for (size_t j = 0; j < bn; j++) {
+		uint32_t carry[MUL_LANES] = {};
+		uint32_t const* multiplier = b + j * count;
+		for (size_t i = 0; i < an; i++) {
+			uint32_t* out = r + (i + j) * count;
+			uint32_t const* row = a + i * count;
+			for (size_t k = 0; k < width; k++) {
+				uint64_t t = static_cast<uint64_t>(row[k]) * multiplier[k] + out[k] + carry[k];
+				out[k] = static_cast<uint32_t>(t);
+				carry[k] = static_cast<uint32_t>(t >> 32u);
+			}
+		}
+		std::copy_n(carry, width, r + (an + j) * count);
+	}
+}
+
+template<bool Full>
+inline void cmp_block(int* out, uint32_t const* a, uint32_t const* b, size_t n, size_t count, size_t width) {
+	size_t const w = Full ? LANES : width;
+	int result[LANES] = {};
+	for (size_t i = n; i > 0; i--) {
+		size_t row = (i - 1) * count;
+		for (size_t k = 0; k < w; k++) {
+			uint32_t x = a[row + k];
+			uint32_t y = b[row + k];
+			result[k] = result[k] != 0 ? result[k] : (x > y) - (x < y);
+		}
+	}
+	std::copy_n(result, w, out);
+}
+}
+
+limb_batch::limb_batch(size_t limbs, size_t count) : limbs_(limbs), count_(count), data_(limbs * count) {}
+
+void limb_batch::set(size_t j, big_integer const& value) {
+	size_t n = value.digits_.size();
+	if (value.sign_ || n > limbs_) {
+		throw std::runtime_error("Value does not fit in limb_batch");
+	}
+	for (size_t i = 0; i < limbs_; i++) {
+		row(i)[j] = i < n ? value.digits_[i] : 0;
+	}
+}
+
+big_integer limb_batch::get(size_t j) const {
+	scratch_frame frame;
+	uint32_t* limbs = frame.allocate(limbs_);
+	for (size_t i = 0; i < limbs_; i++) {
+		limbs[i] = row(i)[j];
+	}
+	big_integer result;
+	result.assign_digits(limbs, limbs_, false);
+	return result;
+}
+
+BATCH_KERNEL
+void add_n_batch(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n, size_t count, uint32_t* carry) {
+	size_t j = 0;
+	for (; j + LANES <= count; j += LANES) {
+		add_block<true>(r + j, a + j, b + j, n, count, carry + j, LANES);
+	}
+	if (j < count) {
+		add_block<false>(r + j, a + j, b + j, n, count, carry + j, count - j);
+	}
+}
+
+BATCH_KERNEL
+void mul_batch(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t count) {
+	for (size_t j = 0; j < count; j += MUL_LANES) {
+		mul_block(r + j, a + j, an, b + j, bn, count, std::min(MUL_LANES, count - j));
+	}
+}
+
+BATCH_KERNEL
+void cmp_batch(int* out, uint32_t const* a, uint32_t const* b, size_t n, size_t count) {
+	size_t j = 0;
+	for (; j + LANES <= count; j += LANES) {
+		cmp_block<true>(out + j, a + j, b + j, n, count, LANES);
+	}
+	if (j < count) {
+		cmp_block<false>(out + j, a + j, b + j, n, count, count - j);
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef BIGINT_LIMB_BATCH_H
+#define BIGINT_LIMB_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// Struct-of-arrays storage for a column of non-negative numbers of the same
+// limb count: limb i of number j lives at row(i)[j]. A vector register then
+// holds the same limb of several numbers, and the batch kernels below run
+// one independent carry chain per lane.
+class limb_batch {
+public:
+	limb_batch(size_t limbs, size_t count);
+
+	size_t limbs() const {
+		return limbs_;
+	}
+
+	size_t count() const {
+		return count_;
+	}
+
+	uint32_t* data() {
+		return data_.data();
+	}
+
+	uint32_t const* data() const {
+		return data_.data();
+	}
+
+	uint32_t* row(size_t i) {
+		return data_.data() + i * count_;
+	}
+
+	uint32_t const* row(size_t i) const {
+		return data_.data() + i * count_;
+	}
+
+	// Throws std::runtime_error if value is negative or needs more limbs.
+	void set(size_t j, big_integer const& value);
+	big_integer get(size_t j) const;
+
+private:
+	size_t limbs_;
+	size_t count_;
+	std::vector<uint32_t> data_;
+};
+
+// The kernels take count numbers laid out as in limb_batch: operand rows
+// are count limbs apart.
+
+// r = a + b with n limbs each; carry[j] is set to the carry out of number j.
+// r may be a or b.
+void add_n_batch(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n, size_t count, uint32_t* carry);
+
+// r = a * b with an + bn rows of output; r must not overlap the operands.
+void mul_batch(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t count);
+
+// out[j] is -1, 0 or 1 as number j of a is less than, equal to or greater
+// than number j of b, both of n limbs.
+void cmp_batch(int* out, uint32_t const* a, uint32_t const* b, size_t n, size_t count);
+#endif //BIGINT_LIMB_BATCH_H
@@ -0,0 +1,288 @@
+#include "limb_dispatch.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+// Every kernel is compiled once per tier with the matching target
+// attribute and the table is filled on first use, so one binary runs the
+// best code the CPU has. The x86 tiers need GCC's target attributes and
+// __builtin_cpu_supports; elsewhere only the generic tier exists.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define KERNEL_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+char const* const TIER_NAMES[] = {"generic", "bmi2_adx", "avx2", "avx512"};
+
+// The loop bodies are shared by all tiers and inlined into each target
+// function, where they get vectorized for its instruction set.
+template<typename Op>
+inline __attribute__((always_inline)) void bitwise(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n, Op op) {
+	for (size_t i = 0; i < n; i++) {
+		r[i] = op(a[i], b[i]);
+	}
+}
+
+inline __attribute__((always_inline)) size_t popcount_loop(uint32_t const* a, size_t n) {
+	size_t result = 0;
+	for (size_t i = 0; i < n; i++) {
+		result += static_cast<size_t>(__builtin_popcount(a[i]));
+	}
+	return result;
+}
+
+#define BITWISE_KERNELS(suffix, attributes)                                                       \
+	attributes void and_n_##suffix(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) { \
+		bitwise(r, a, b, n, [](uint32_t x, uint32_t y) { return x & y; });                        \
+	}                                                                                             \
+	attributes void or_n_##suffix(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {  \
+		bitwise(r, a, b, n, [](uint32_t x, uint32_t y) { return x | y; });                        \
+	}                                                                                             \
+	attributes void xor_n_##suffix(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) { \
+		bitwise(r, a, b, n, [](uint32_t x, uint32_t y) { return x ^ y; });                        \
+	}
+
+uint32_t add_n_generic(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	return limbs::add_n(r, a, b, n);
+}
+
+uint32_t sub_n_generic(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	return limbs::sub_n(r, a, b, n);
+}
+
+uint32_t mul_1_generic(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	return limbs::mul_1(r, a, n, b);
+}
+
+uint32_t addmul_1_generic(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	return limbs::addmul_1(r, a, n, b);
+}
+
+BITWISE_KERNELS(generic, )
+
+size_t popcount_generic(uint32_t const* a, size_t n) {
+	return popcount_loop(a, n);
+}
+
+#ifdef KERNEL_DISPATCH
+// Pairs of limbs are handled as one 64-bit word, with a 32-bit limb left
+// over for odd lengths: additions take one adc per word and products one
+// mulx. The additions need nothing past x86-64, the gain over the generic
+// loop is the halved number of carries. Words are loaded with memcpy, the
+// limb arrays are only 4-byte aligned.
+#define BMI2_KERNEL __attribute__((target("bmi2")))
+
+uint32_t add_n_64(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	unsigned char carry = 0;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		unsigned long long x, y, sum;
+		std::memcpy(&x, a + i, sizeof(x));
+		std::memcpy(&y, b + i, sizeof(y));
+		carry = _addcarry_u64(carry, x, y, &sum);
+		std::memcpy(r + i, &sum, sizeof(sum));
+	}
+	if (i < n) {
+		unsigned int sum;
+		carry = _addcarry_u32(carry, a[i], b[i], &sum);
+		r[i] = sum;
+	}
+	return carry;
+}
+
+uint32_t sub_n_64(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	unsigned char borrow = 0;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		unsigned long long x, y, diff;
+		std::memcpy(&x, a + i, sizeof(x));
+		std::memcpy(&y, b + i, sizeof(y));
+		borrow = _subborrow_u64(borrow, x, y, &diff);
+		std::memcpy(r + i, &diff, sizeof(diff));
+	}
+	if (i < n) {
+		unsigned int diff;
+		borrow = _subborrow_u32(borrow, a[i], b[i], &diff);
+		r[i] = diff;
+	}
+	return borrow;
+}
+
+// A word times a limb plus two words fits in 96 bits, so the carry between
+// words stays below 2^32. With BMI2 the products compile to mulx, which
+// leaves the flags alone.
+__extension__ typedef unsigned __int128 uint128_t;
+
+BMI2_KERNEL uint32_t mul_1_bmi2(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	unsigned long long carry = 0;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		unsigned long long x;
+		std::memcpy(&x, a + i, sizeof(x));
+		uint128_t t = static_cast<uint128_t>(x) * b + carry;
+		unsigned long long low = static_cast<unsigned long long>(t);
+		carry = static_cast<unsigned long long>(t >> 64u);
+		std::memcpy(r + i, &low, sizeof(low));
+	}
+	if (i < n) {
+		carry += static_cast<uint64_t>(a[i]) * b;
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+BMI2_KERNEL uint32_t addmul_1_bmi2(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	unsigned long long carry = 0;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		unsigned long long x, y;
+		std::memcpy(&x, a + i, sizeof(x));
+		std::memcpy(&y, r + i, sizeof(y));
+		uint128_t t = static_cast<uint128_t>(x) * b + y + carry;
+		unsigned long long low = static_cast<unsigned long long>(t);
+		carry = static_cast<unsigned long long>(t >> 64u);
+		std::memcpy(r + i, &low, sizeof(low));
+	}
+	if (i < n) {
+		carry += static_cast<uint64_t>(a[i]) * b + r[i];
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+__attribute__((target("popcnt"))) size_t popcount_popcnt(uint32_t const* a, size_t n) {
+	return popcount_loop(a, n);
+}
+
+BITWISE_KERNELS(avx2, __attribute__((target("avx2"))))
+BITWISE_KERNELS(avx512, __attribute__((target("avx512f"))))
+
+// Not every AVX-512 CPU has VPOPCNTDQ, the avx512 table checks for it.
+__attribute__((target("avx512f,avx512vpopcntdq")))
+size_t popcount_avx512(uint32_t const* a, size_t n) {
+	return popcount_loop(a, n);
+}
+#endif
+
+// Extensions the kernels need, each detected on its own.
+struct cpu_features {
+	bool bmi2 = false;
+	bool popcnt = false;
+	bool avx2 = false;
+	bool avx512f = false;
+	bool avx512vpopcntdq = false;
+};
+
+cpu_features detect_features() {
+	cpu_features result;
+#ifdef KERNEL_DISPATCH
+	__builtin_cpu_init();
+	result.bmi2 = __builtin_cpu_supports("bmi2");
+	result.popcnt = __builtin_cpu_supports("popcnt");
+	result.avx2 = __builtin_cpu_supports("avx2");
+	result.avx512f = __builtin_cpu_supports("avx512f");
+	result.avx512vpopcntdq = __builtin_cpu_supports("avx512vpopcntdq");
+#endif
+	return result;
+}
+
+cpu_features const& features() {
+	static cpu_features const result = detect_features();
+	return result;
+}
+
+limbs::kernel_table make_table(limbs::cpu_tier tier) {
+	limbs::kernel_table table = {
+		tier, TIER_NAMES[static_cast<size_t>(tier)],
+		add_n_generic, sub_n_generic, mul_1_generic, addmul_1_generic,
+		and_n_generic, or_n_generic, xor_n_generic, popcount_generic
+	};
+#ifdef KERNEL_DISPATCH
+	cpu_features const& cpu = features();
+	if (tier >= limbs::cpu_tier::bmi2_adx) {
+		table.add_n = add_n_64;
+		table.sub_n = sub_n_64;
+		if (cpu.bmi2) {
+			table.mul_1 = mul_1_bmi2;
+			table.addmul_1 = addmul_1_bmi2;
+		}
+		if (cpu.popcnt) {
+			table.popcount = popcount_popcnt;
+		}
+	}
+	if (tier >= limbs::cpu_tier::avx2 && cpu.avx2) {
+		table.and_n = and_n_avx2;
+		table.or_n = or_n_avx2;
+		table.xor_n = xor_n_avx2;
+	}
+	if (tier >= limbs::cpu_tier::avx512 && cpu.avx512f) {
+		table.and_n = and_n_avx512;
+		table.or_n = or_n_avx512;
+		table.xor_n = xor_n_avx512;
+		if (cpu.avx512vpopcntdq) {
+			table.popcount = popcount_avx512;
+		}
+	}
+#endif
+	return table;
+}
+
+limbs::cpu_tier detect_tier() {
+	cpu_features const& cpu = features();
+	if (cpu.avx512f) {
+		return limbs::cpu_tier::avx512;
+	}
+	if (cpu.avx2) {
+		return limbs::cpu_tier::avx2;
+	}
+#ifdef KERNEL_DISPATCH
+	return limbs::cpu_tier::bmi2_adx;
+#else
+	return limbs::cpu_tier::generic;
+#endif
+}
+
+limbs::cpu_tier requested_tier() {
+	limbs::cpu_tier tier = limbs::supported_tier();
+	char const* name = std::getenv("BIGINT_CPU_TIER");
+	if (name == nullptr) {
+		return tier;
+	}
+	for (size_t i = 0; i < std::size(TIER_NAMES); i++) {
+		if (std::strcmp(name, TIER_NAMES[i]) == 0) {
+			return std::min(tier, static_cast<limbs::cpu_tier>(i));
+		}
+	}
+	return tier;
+}
+}
+
+namespace limbs {
+
+cpu_tier supported_tier() {
+	static cpu_tier const tier = detect_tier();
+	return tier;
+}
+
+kernel_table const& kernels(cpu_tier tier) {
+	static kernel_table const tables[] = {
+		make_table(cpu_tier::generic),
+		make_table(std::min(cpu_tier::bmi2_adx, supported_tier())),
+		make_table(std::min(cpu_tier::avx2, supported_tier())),
+		make_table(std::min(cpu_tier::avx512, supported_tier()))
+	};
+	return tables[static_cast<size_t>(std::min(tier, supported_tier()))];
+}
+
+kernel_table const& kernels() {
+	static kernel_table const& table = kernels(requested_tier());
+	return table;
+}
+
+} // namespace limbs
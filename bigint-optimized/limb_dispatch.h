@@ -0,0 +1,48 @@
+#ifndef BIGINT_LIMB_DISPATCH_H
+#define BIGINT_LIMB_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace limbs {
+
+// Instruction set levels the kernels are built for. A tier is a cap: its
+// table takes every kernel of that tier and the ones before it whose own
+// extension the CPU has, each checked on its own. bmi2_adx is the floor on
+// any x86-64 CPU: its additions run on 64-bit words with a plain adc, only
+// the mulx products wait for BMI2 and the popcount for POPCNT.
+enum class cpu_tier {
+	generic,
+	bmi2_adx,
+	avx2,
+	avx512
+};
+
+// The limb loops that differ between instruction sets. The arithmetic ones
+// behave like their constexpr namesakes in limb_kernels.h; the bitwise ones
+// store a op b into r, which may be a or b.
+struct kernel_table {
+	cpu_tier tier;
+	char const* name;
+	uint32_t (*add_n)(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n);
+	uint32_t (*sub_n)(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n);
+	uint32_t (*mul_1)(uint32_t* r, uint32_t const* a, size_t n, uint32_t b);
+	uint32_t (*addmul_1)(uint32_t* r, uint32_t const* a, size_t n, uint32_t b);
+	void (*and_n)(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n);
+	void (*or_n)(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n);
+	void (*xor_n)(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n);
+	size_t (*popcount)(uint32_t const* a, size_t n);
+};
+
+// Highest tier with at least one kernel the CPU can run.
+cpu_tier supported_tier();
+
+// Table for the given tier, or for the supported one if that is lower.
+kernel_table const& kernels(cpu_tier tier);
+
+// Table picked on first use: the supported tier, unless BIGINT_CPU_TIER
+// names a lower one (generic, bmi2_adx, avx2 or avx512).
+kernel_table const& kernels();
+
+} // namespace limbs
+#endif //BIGINT_LIMB_DISPATCH_H
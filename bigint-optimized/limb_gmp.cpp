@@ -0,0 +1,70 @@
+#include "limb_gmp.h"
+
+#ifdef BIGINT_GMP
+#include <cstring>
+#include <gmp.h>
+#include "scratch_arena.h"
+
+namespace {
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "limbs are copied to mp_limb_t byte for byte");
+static_assert(GMP_NAIL_BITS == 0 && GMP_LIMB_BITS % 32 == 0, "an mp_limb_t must hold whole limbs");
+
+size_t const PER_MP_LIMB = GMP_LIMB_BITS / 32;
+
+size_t mp_size(size_t n) {
+	return (n + PER_MP_LIMB - 1) / PER_MP_LIMB;
+}
+
+// The arena hands out 4-byte aligned limbs, one mp_limb_t more is enough
+// to align the start.
+mp_limb_t* allocate(scratch_frame& frame, size_t k) {
+	uint32_t* p = frame.allocate((k + 1) * PER_MP_LIMB);
+	uintptr_t address = reinterpret_cast<uintptr_t>(p);
+	address = (address + alignof(mp_limb_t) - 1) & ~static_cast<uintptr_t>(alignof(mp_limb_t) - 1);
+	return reinterpret_cast<mp_limb_t*>(address);
+}
+
+// Copies n limbs with zeros up to the next whole mp_limb_t.
+mp_limb_t* import(scratch_frame& frame, uint32_t const* a, size_t n) {
+	size_t k = mp_size(n);
+	mp_limb_t* result = allocate(frame, k);
+	result[k - 1] = 0;
+	std::memcpy(result, a, n * sizeof(uint32_t));
+	return result;
+}
+}
+
+namespace limbs {
+
+void gmp_mul(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	scratch_frame frame;
+	size_t ak = mp_size(an), bk = mp_size(bn);
+	mp_limb_t const* x = import(frame, a, an);
+	mp_limb_t* product = allocate(frame, ak + bk);
+	if (a == b && an == bn) {
+		mpn_sqr(product, x, static_cast<mp_size_t>(ak));
+	} else {
+		mp_limb_t const* y = import(frame, b, bn);
+		mpn_mul(product, x, static_cast<mp_size_t>(ak), y, static_cast<mp_size_t>(bk));
+	}
+	std::memcpy(r, product, (an + bn) * sizeof(uint32_t));
+}
+
+void gmp_divrem(uint32_t* q, uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	scratch_frame frame;
+	size_t ak = mp_size(an), bk = mp_size(bn);
+	mp_limb_t const* x = import(frame, a, an);
+	mp_limb_t const* y = import(frame, b, bn);
+	mp_limb_t* quotient = allocate(frame, ak - bk + 1);
+	mp_limb_t* remainder = allocate(frame, bk);
+	mpn_tdiv_qr(quotient, remainder, 0, x, static_cast<mp_size_t>(ak), y, static_cast<mp_size_t>(bk));
+	if (q) {
+		std::memcpy(q, quotient, (an - bn + 1) * sizeof(uint32_t));
+	}
+	if (r) {
+		std::memcpy(r, remainder, bn * sizeof(uint32_t));
+	}
+}
+
+} // namespace limbs
+#endif
@@ -0,0 +1,29 @@
+#ifndef BIGINT_LIMB_GMP_H
+#define BIGINT_LIMB_GMP_H
+
+#include <cstddef>
+#include <cstdint>
+
+// With BIGINT_GMP defined (cmake -DBIGINT_GMP=ON) multiplication and
+// division of magnitudes run on GMP's mpn kernels instead of the ones in
+// limb_multiply.cpp and limb_kernels.h. Only the magnitudes change hands:
+// signs, shifts and the two's complement bitwise operations stay native,
+// so big_integer behaves the same with either backend.
+//
+// The limbs are copied into mp_limb_t buffers and back, a linear cost next
+// to the products and quotients it buys.
+#ifdef BIGINT_GMP
+namespace limbs {
+
+// r = a * b with an + bn limbs of output for an >= bn > 0; r must not
+// overlap the operands.
+void gmp_mul(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn);
+
+// q = a / b with an - bn + 1 limbs and r = a % b with bn limbs, for
+// an >= bn > 0 and a nonzero top limb of b. Either output may be null.
+void gmp_divrem(uint32_t* q, uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn);
+
+} // namespace limbs
+#endif
+
+#endif //BIGINT_LIMB_GMP_H
@@ -0,0 +1,347 @@
+#ifndef BIGINT_LIMB_KERNELS_H
+#define BIGINT_LIMB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Loops over raw little-endian limb arrays. The result may alias an operand
+// as long as it starts at the same limb. They are constexpr so that the
+// fixed-width integers can use them in constant expressions.
+namespace limbs {
+
+constexpr uint32_t add_n(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	uint64_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		carry += static_cast<uint64_t>(a[i]) + b[i];
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+constexpr uint32_t add_1(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	uint64_t carry = b;
+	for (size_t i = 0; i < n; i++) {
+		carry += a[i];
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+constexpr uint32_t sub_n(uint32_t* r, uint32_t const* a, uint32_t const* b, size_t n) {
+	uint32_t borrow = 0;
+	for (size_t i = 0; i < n; i++) {
+		uint64_t diff = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+		r[i] = static_cast<uint32_t>(diff);
+		borrow = static_cast<uint32_t>(diff >> 63u);
+	}
+	return borrow;
+}
+
+constexpr uint32_t sub_1(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	uint32_t borrow = b;
+	for (size_t i = 0; i < n; i++) {
+		uint64_t diff = static_cast<uint64_t>(a[i]) - borrow;
+		r[i] = static_cast<uint32_t>(diff);
+		borrow = static_cast<uint32_t>(diff >> 63u);
+	}
+	return borrow;
+}
+
+// r = a * b, returns the limb carried out of the top.
+constexpr uint32_t mul_1(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	uint64_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		carry += static_cast<uint64_t>(a[i]) * b;
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+// r += a * b, returns the limb carried out of the top.
+constexpr uint32_t addmul_1(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	uint64_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		carry += static_cast<uint64_t>(a[i]) * b + r[i];
+		r[i] = static_cast<uint32_t>(carry);
+		carry >>= 32u;
+	}
+	return static_cast<uint32_t>(carry);
+}
+
+// r -= a * b, returns the limb borrowed from above the top.
+constexpr uint32_t submul_1(uint32_t* r, uint32_t const* a, size_t n, uint32_t b) {
+	uint32_t borrow = 0;
+	for (size_t i = 0; i < n; i++) {
+		uint64_t prod = static_cast<uint64_t>(a[i]) * b + borrow;
+		uint32_t low = static_cast<uint32_t>(prod);
+		borrow = static_cast<uint32_t>(prod >> 32u) + (r[i] < low);
+		r[i] -= low;
+	}
+	return borrow;
+}
+
+// Leading and trailing zero bits of a nonzero limb.
+constexpr uint32_t clz(uint32_t x) {
+	return static_cast<uint32_t>(__builtin_clz(x));
+}
+
+constexpr uint32_t ctz(uint32_t x) {
+	return static_cast<uint32_t>(__builtin_ctz(x));
+}
+
+// Position of the top set bit plus one, zero for n == 0. The top limb must
+// be nonzero.
+constexpr size_t bit_length(uint32_t const* a, size_t n) {
+	return n == 0 ? 0 : 32 * n - clz(a[n - 1]);
+}
+
+// r = a * b with an + bn limbs of output; r must not overlap the operands.
+constexpr void mul_basecase(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	r[an] = mul_1(r, a, an, b[0]);
+	for (size_t j = 1; j < bn; j++) {
+		r[an + j] = addmul_1(r + j, a, an, b[j]);
+	}
+}
+
+// Single-limb divisor with a precomputed reciprocal, after Moller and
+// Granlund, "Improved division by invariant integers". A quotient limb then
+// costs two multiplications instead of a hardware division. The divisor is
+// kept shifted to have its top bit set, and dividends are shifted along on
+// the fly. Building it takes one division, so it pays off for dividends of
+// several limbs or for a divisor that is used many times.
+struct divisor_1 {
+	uint32_t value;
+	uint32_t shift;
+	uint32_t normalized;
+	uint32_t inverse;
+
+	constexpr explicit divisor_1(uint32_t d)
+		: value(d),
+		  shift(clz(d)),
+		  normalized(d << shift),
+		  inverse(static_cast<uint32_t>(UINT64_MAX / normalized - (static_cast<uint64_t>(1) << 32u))) {}
+
+	// <u1, u0> / normalized for u1 < normalized; stores the remainder in r.
+	constexpr uint32_t divide(uint32_t u1, uint32_t u0, uint32_t& r) const {
+		uint64_t q = static_cast<uint64_t>(inverse) * u1 + ((static_cast<uint64_t>(u1) << 32u) | u0);
+		uint32_t q1 = static_cast<uint32_t>(q >> 32u) + 1;
+		r = u0 - q1 * normalized;
+		if (r > static_cast<uint32_t>(q)) {
+			q1--;
+			r += normalized;
+		}
+		if (r >= normalized) {
+			q1++;
+			r -= normalized;
+		}
+		return q1;
+	}
+
+	// Limb i of the dividend shifted left by shift, given the limb below it.
+	constexpr uint32_t shifted(uint32_t limb, uint32_t below) const {
+		return shift ? (limb << shift) | (below >> (32u - shift)) : limb;
+	}
+};
+
+// q = a / d, returns a % d. Goes from the top limb down and reads limb i - 1
+// before it writes limb i, so q may be a.
+constexpr uint32_t divrem_1(uint32_t* q, uint32_t const* a, size_t n, divisor_1 const& d) {
+	if (n == 0) {
+		return 0;
+	}
+	uint32_t r = d.shift ? a[n - 1] >> (32u - d.shift) : 0;
+	for (size_t i = n; i > 0; i--) {
+		q[i - 1] = d.divide(r, d.shifted(a[i - 1], i > 1 ? a[i - 2] : 0), r);
+	}
+	return r >> d.shift;
+}
+
+constexpr uint32_t divrem_1(uint32_t* q, uint32_t const* a, size_t n, uint32_t d) {
+	return divrem_1(q, a, n, divisor_1(d));
+}
+
+// Returns a % d without storing the quotient.
+constexpr uint32_t mod_1(uint32_t const* a, size_t n, divisor_1 const& d) {
+	if (n == 0) {
+		return 0;
+	}
+	uint32_t r = d.shift ? a[n - 1] >> (32u - d.shift) : 0;
+	for (size_t i = n; i > 0; i--) {
+		d.divide(r, d.shifted(a[i - 1], i > 1 ? a[i - 2] : 0), r);
+	}
+	return r >> d.shift;
+}
+
+constexpr uint32_t mod_1(uint32_t const* a, size_t n, uint32_t d) {
+	return mod_1(a, n, divisor_1(d));
+}
+
+// Two-limb divisor <high, low> with its top bit set and the reciprocal
+// floor((B^3 - 1) / <high, low>) - B for B = 2^32, after the same paper. It
+// divides three limbs by two with two multiplications, which is what
+// algorithm D needs to estimate a quotient limb.
+struct divisor_2 {
+	uint32_t high;
+	uint32_t low;
+	uint32_t inverse;
+
+	// Starts from the reciprocal of high alone and corrects it for low.
+	constexpr divisor_2(uint32_t high, uint32_t low)
+		: high(high), low(low), inverse(divisor_1(high).inverse) {
+		uint32_t p = high * inverse + low;
+		if (p < low) {
+			inverse--;
+			if (p >= high) {
+				inverse--;
+				p -= high;
+			}
+			p -= high;
+		}
+		uint64_t t = static_cast<uint64_t>(low) * inverse;
+		uint32_t t1 = static_cast<uint32_t>(t >> 32u);
+		p += t1;
+		if (p < t1) {
+			inverse--;
+			if (p > high || (p == high && static_cast<uint32_t>(t) >= low)) {
+				inverse--;
+			}
+		}
+	}
+
+	// <u2, u1, u0> / <high, low> for <u2, u1> < <high, low>; stores the
+	// remainder in r.
+	constexpr uint32_t divide(uint32_t u2, uint32_t u1, uint32_t u0, uint64_t& r) const {
+		uint64_t const d = (static_cast<uint64_t>(high) << 32u) | low;
+		uint64_t q = static_cast<uint64_t>(inverse) * u2 + ((static_cast<uint64_t>(u2) << 32u) | u1);
+		uint32_t q1 = static_cast<uint32_t>(q >> 32u);
+		uint32_t r1 = u1 - q1 * high;
+		r = ((static_cast<uint64_t>(r1) << 32u) | u0) - d - static_cast<uint64_t>(low) * q1;
+		q1++;
+		if (static_cast<uint32_t>(r >> 32u) >= static_cast<uint32_t>(q)) {
+			q1--;
+			r += d;
+		}
+		if (r >= d) {
+			q1++;
+			r -= d;
+		}
+		return q1;
+	}
+};
+
+// Knuth's algorithm D for a divisor v of vn >= 2 limbs whose top bit is set,
+// with d built from its top two limbs. u holds un + 1 limbs, the top one
+// catching the bits shifted out when the dividend was normalized along with
+// v. Writes un - vn + 1 quotient limbs to q unless it is null and leaves the
+// remainder in the low vn limbs of u. Every quotient limb is estimated from
+// the top three limbs of the running remainder, which is off by at most one.
+constexpr void divrem_normalized(uint32_t* q, uint32_t* u, size_t un, uint32_t const* v, size_t vn,
+                                 divisor_2 const& d) {
+	for (size_t j = un - vn + 1; j > 0; j--) {
+		uint32_t* window = u + j - 1;
+		uint32_t qt = UINT32_MAX;
+		if (window[vn] != d.high || window[vn - 1] != d.low) {
+			uint64_t r = 0;
+			qt = d.divide(window[vn], window[vn - 1], window[vn - 2], r);
+		}
+		uint32_t borrow = submul_1(window, v, vn, qt);
+		uint32_t high = window[vn];
+		window[vn] = high - borrow;
+		if (high < borrow) {
+			qt--;
+			window[vn] += add_n(window, window, v, vn);
+		}
+		if (q) {
+			q[j - 1] = qt;
+		}
+	}
+}
+
+constexpr void divrem_normalized(uint32_t* q, uint32_t* u, size_t un, uint32_t const* v, size_t vn) {
+	divrem_normalized(q, u, un, v, vn, divisor_2(v[vn - 1], v[vn - 2]));
+}
+
+// r = a << cnt for 0 < cnt < 32, returns the bits shifted out of the top.
+constexpr uint32_t lshift(uint32_t* r, uint32_t const* a, size_t n, uint32_t cnt) {
+	uint32_t out = 0;
+	for (size_t i = 0; i < n; i++) {
+		uint32_t cur = a[i];
+		r[i] = (cur << cnt) | out;
+		out = cur >> (32u - cnt);
+	}
+	return out;
+}
+
+// r = a >> cnt for 0 < cnt < 32, returns the bits shifted out of the bottom.
+constexpr uint32_t rshift(uint32_t* r, uint32_t const* a, size_t n, uint32_t cnt) {
+	uint32_t out = 0;
+	for (size_t i = n; i > 0; i--) {
+		uint32_t cur = a[i - 1];
+		r[i - 1] = (cur >> cnt) | out;
+		out = cur << (32u - cnt);
+	}
+	return out;
+}
+
+constexpr int cmp_n(uint32_t const* a, uint32_t const* b, size_t n) {
+	for (size_t i = n; i > 0; i--) {
+		if (a[i - 1] != b[i - 1]) {
+			return a[i - 1] < b[i - 1] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+constexpr size_t normalized_size(uint32_t const* a, size_t n) {
+	while (n > 0 && a[n - 1] == 0) {
+		n--;
+	}
+	return n;
+}
+
+constexpr uint64_t rotl(uint64_t x, uint32_t r) {
+	return (x << r) | (x >> (64u - r));
+}
+
+constexpr uint64_t mix(uint64_t x) {
+	x ^= x >> 33u;
+	x *= 0xFF51AFD7ED558CCDull;
+	x ^= x >> 33u;
+	x *= 0xC4CEB9FE1A85EC53ull;
+	x ^= x >> 33u;
+	return x;
+}
+
+// Seeded hash of a limb array. The main loop runs four independent 64-bit
+// lanes over stripes of eight limbs and only multiplies 32-bit halves, so
+// it maps onto 256-bit vector multiplies; the tail is mixed in serially.
+constexpr uint64_t hash(uint32_t const* a, size_t n, uint64_t seed) {
+	uint64_t const p1 = 0x9E3779B185EBCA87ull;
+	uint64_t const p2 = 0xC2B2AE3D27D4EB4Full;
+	uint64_t const p3 = 0x165667B19E3779F9ull;
+	uint64_t const p4 = 0x85EBCA77C2B2AE63ull;
+	uint64_t const key[4] = {p1 + seed, p2 - seed, p3 ^ seed, p4 + rotl(seed, 17)};
+	uint64_t acc[4] = {p3, p4 ^ seed, p1, p2 + seed};
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		for (size_t lane = 0; lane < 4; lane++) {
+			uint64_t word = a[i + 2 * lane] | (static_cast<uint64_t>(a[i + 2 * lane + 1]) << 32u);
+			uint64_t keyed = word ^ key[lane];
+			acc[lane] += (keyed & UINT32_MAX) * (keyed >> 32u) + word;
+		}
+	}
+	uint64_t h = seed + n * p1;
+	for (uint64_t lane : acc) {
+		h = rotl(h ^ mix(lane), 27) * p1 + p4;
+	}
+	for (; i < n; i++) {
+		h = rotl(h ^ (a[i] * p2), 31) * p1;
+	}
+	return mix(h);
+}
+
+} // namespace limbs
+#endif //BIGINT_LIMB_KERNELS_H
@@ -0,0 +1,120 @@
+#include "limb_multiply.h"
+#include "limb_dispatch.h"
+#include "limb_gmp.h"
+#include "limb_kernels.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+// Below this many limbs in the shorter operand the schoolbook product is
+// faster than splitting it.
+size_t const KARATSUBA_THRESHOLD = 32;
+// Branches are only forked for operands at least this long, smaller ones
+// finish before a task would be picked up.
+size_t const PARALLEL_THRESHOLD = 1024;
+#ifdef BIGINT_GMP
+// From this many limbs in the shorter operand mpn_mul beats the schoolbook
+// product even with the copies.
+size_t const GMP_MUL_THRESHOLD = 2;
+#endif
+
+// r = a + b for an >= bn, returns the carry.
+uint32_t add(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	uint32_t carry = limbs::kernels().add_n(r, a, b, bn);
+	return limbs::add_1(r + bn, a + bn, an - bn, carry);
+}
+
+// a -= b for an >= bn, returns the borrow.
+uint32_t sub(uint32_t* a, size_t an, uint32_t const* b, size_t bn) {
+	uint32_t borrow = limbs::kernels().sub_n(a, a, b, bn);
+	return limbs::sub_1(a + bn, a + bn, an - bn, borrow);
+}
+
+// limbs::mul_basecase through the kernels picked for this CPU.
+void mul_basecase(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn) {
+	limbs::kernel_table const& k = limbs::kernels();
+	r[an] = k.mul_1(r, a, an, b[0]);
+	for (size_t j = 1; j < bn; j++) {
+		r[an + j] = k.addmul_1(r + j, a, an, b[j]);
+	}
+}
+
+void mul_rec(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads);
+
+// Multiplies by slices of a as long as b, each slice a balanced product.
+void mul_unbalanced(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads) {
+	mul_rec(r, a, bn, b, bn, threads);
+	scratch_frame frame;
+	uint32_t* slice = frame.allocate(2 * bn);
+	for (size_t i = bn; i < an; i += bn) {
+		size_t len = std::min(bn, an - i);
+		if (len == bn) {
+			mul_rec(slice, a + i, len, b, bn, threads);
+		} else {
+			mul_rec(slice, b, bn, a + i, len, threads);
+		}
+		std::copy_n(slice + bn, len, r + i + bn);
+		uint32_t carry = limbs::kernels().add_n(r + i, r + i, slice, bn);
+		limbs::add_1(r + i + bn, r + i + bn, len, carry);
+	}
+}
+
+// With a = a1 B^h + a0 and b = b1 B^h + b0 the product is
+// z2 B^2h + (z1 - z2 - z0) B^h + z0 for z0 = a0 b0, z2 = a1 b1 and
+// z1 = (a0 + a1)(b0 + b1). z0 and z2 go straight to their places in r.
+void karatsuba(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads) {
+	size_t h = (an + 1) / 2;
+	size_t rn = an + bn;
+	scratch_frame frame;
+	uint32_t* s = frame.allocate(h + 1);
+	uint32_t* t = frame.allocate(h + 1);
+	uint32_t* z1 = frame.allocate(2 * h + 2);
+	auto middle = [&](size_t budget) {
+		s[h] = add(s, a, h, a + h, an - h);
+		t[h] = add(t, b, h, b + h, bn - h);
+		mul_rec(z1, s, h + 1, t, h + 1, budget);
+	};
+	if (threads > 1 && bn >= PARALLEL_THRESHOLD) {
+		size_t budget = (threads + 2) / 3;
+		task_group group(thread_pool::global());
+		group.run([=] { mul_rec(r, a, h, b, h, budget); });
+		group.run([=] { mul_rec(r + 2 * h, a + h, an - h, b + h, bn - h, budget); });
+		middle(budget);
+		group.wait();
+	} else {
+		mul_rec(r, a, h, b, h, 1);
+		mul_rec(r + 2 * h, a + h, an - h, b + h, bn - h, 1);
+		middle(1);
+	}
+	sub(z1, 2 * h + 2, r, 2 * h);
+	sub(z1, 2 * h + 2, r + 2 * h, rn - 2 * h);
+	size_t zn = limbs::normalized_size(z1, 2 * h + 2);
+	add(r + h, r + h, rn - h, z1, zn);
+}
+
+void mul_rec(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads) {
+	if (bn < KARATSUBA_THRESHOLD) {
+		mul_basecase(r, a, an, b, bn);
+	} else if (bn <= (an + 1) / 2) {
+		mul_unbalanced(r, a, an, b, bn, threads);
+	} else {
+		karatsuba(r, a, an, b, bn, threads);
+	}
+}
+}
+
+namespace limbs {
+
+void mul(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads) {
+#ifdef BIGINT_GMP
+	if (bn >= GMP_MUL_THRESHOLD) {
+		gmp_mul(r, a, an, b, bn);
+		return;
+	}
+#endif
+	mul_rec(r, a, an, b, bn, threads);
+}
+
+} // namespace limbs
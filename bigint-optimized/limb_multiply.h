@@ -0,0 +1,16 @@
+#ifndef BIGINT_LIMB_MULTIPLY_H
+#define BIGINT_LIMB_MULTIPLY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace limbs {
+
+// r = a * b with an + bn limbs of output for an >= bn > 0; r must not
+// overlap the operands. Large operands are split by Karatsuba, and the
+// branches of the upper levels run on up to threads threads of the global
+// thread_pool.
+void mul(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn, size_t threads = 1);
+
+} // namespace limbs
+#endif //BIGINT_LIMB_MULTIPLY_H
@@ -0,0 +1,84 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+[[noreturn]] void system_error(std::string const& what, std::string const& path) {
+	throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+}
+
+mapped_big_integer_file::mapped_big_integer_file(std::string const& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		system_error("Cannot open", path);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		system_error("Cannot stat", path);
+	}
+	size_ = static_cast<size_t>(st.st_size);
+	if (size_ != 0) {
+		void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			system_error("Cannot map", path);
+		}
+		madvise(data, size_, MADV_SEQUENTIAL);
+		data_ = static_cast<uint8_t const*>(data);
+	}
+	close(fd);
+}
+
+mapped_big_integer_file::~mapped_big_integer_file() {
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+}
+
+mapped_big_integer_file::iterator::iterator(byte_span bytes, size_t offset) : bytes_(bytes), offset_(offset) {
+	if (offset_ < bytes_.size) {
+		view_ = big_integer_view::from_record({bytes_.data + offset_, bytes_.size - offset_}, record_size_);
+	}
+}
+
+mapped_big_integer_file::iterator& mapped_big_integer_file::iterator::operator++() {
+	*this = iterator(bytes_, offset_ + record_size_);
+	return *this;
+}
+
+mapped_big_integer_file::iterator mapped_big_integer_file::iterator::operator++(int) {
+	iterator old(*this);
+	++*this;
+	return old;
+}
+
+mapped_big_integer_file::iterator mapped_big_integer_file::begin() const {
+	return iterator(bytes(), 0);
+}
+
+mapped_big_integer_file::iterator mapped_big_integer_file::end() const {
+	return iterator(bytes(), size_);
+}
+
+std::vector<size_t> mapped_big_integer_file::index() const {
+	std::vector<size_t> offsets;
+	for (iterator it = begin(); it != end(); ++it) {
+		offsets.push_back(it.offset());
+	}
+	return offsets;
+}
+
+big_integer_view mapped_big_integer_file::at(size_t offset) const {
+	if (offset >= size_) {
+		throw std::out_of_range("Offset past the end of the mapped file");
+	}
+	return big_integer_view::from_record({data_ + offset, size_ - offset});
+}
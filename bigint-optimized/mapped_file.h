@@ -0,0 +1,83 @@
+#ifndef BIGINT_MAPPED_FILE_H
+#define BIGINT_MAPPED_FILE_H
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "big_integer_view.h"
+#include "serialization.h"
+
+// Read-only memory mapping of a file of binary big_integer records, as
+// written by big_integer_writer. Records are handed out as views into the
+// mapping, so nothing is read until it is touched and values larger than
+// memory can be scanned. Views must not outlive the mapping.
+class mapped_big_integer_file {
+public:
+	class iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = big_integer_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = big_integer_view const*;
+		using reference = big_integer_view const&;
+
+		iterator() = default;
+
+		big_integer_view const& operator*() const {
+			return view_;
+		}
+
+		big_integer_view const* operator->() const {
+			return &view_;
+		}
+
+		iterator& operator++();
+		iterator operator++(int);
+
+		size_t offset() const {
+			return offset_;
+		}
+
+		friend bool operator==(iterator const& a, iterator const& b) {
+			return a.offset_ == b.offset_;
+		}
+
+		friend bool operator!=(iterator const& a, iterator const& b) {
+			return a.offset_ != b.offset_;
+		}
+
+	private:
+		friend class mapped_big_integer_file;
+
+		iterator(byte_span bytes, size_t offset);
+
+		byte_span bytes_ = {nullptr, 0};
+		size_t offset_ = 0;
+		size_t record_size_ = 0;
+		big_integer_view view_;
+	};
+
+	explicit mapped_big_integer_file(std::string const& path);
+
+	mapped_big_integer_file(mapped_big_integer_file const&) = delete;
+	mapped_big_integer_file& operator=(mapped_big_integer_file const&) = delete;
+
+	~mapped_big_integer_file();
+
+	byte_span bytes() const {
+		return {data_, size_};
+	}
+
+	iterator begin() const;
+	iterator end() const;
+
+	// Offsets of all records, for random access through at().
+	std::vector<size_t> index() const;
+	big_integer_view at(size_t offset) const;
+
+private:
+	uint8_t const* data_ = nullptr;
+	size_t size_ = 0;
+};
+#endif //BIGINT_MAPPED_FILE_H
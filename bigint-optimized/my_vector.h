@@ -2,24 +2,111 @@
 #define BIGINT_MY_VECTOR_H
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory_resource>
+#include <new>
 #include <vector>
+#include "big_integer_stats.h"
+
+// Memory resource that new limb buffers of the calling thread come from;
+// null stands for std::pmr::get_default_resource(). A buffer remembers the
+// resource it was allocated from, so it must not outlive that resource.
+// Growing a buffer and unsharing a copy-on-write buffer stay in the
+// buffer's own resource. A value still in its small buffer has no
+// resource yet and takes its first heap buffer from the current one: a
+// value that outlives a scoped resource must not grow past the small
+// buffer inside that scope.
+inline std::pmr::memory_resource*& current_limb_resource() {
+	static thread_local std::pmr::memory_resource* resource = nullptr;
+	return resource;
+}
+
+inline std::pmr::memory_resource* get_limb_resource() {
+	std::pmr::memory_resource* resource = current_limb_resource();
+	return resource ? resource : std::pmr::get_default_resource();
+}
+
+// Returns the previous resource, possibly null.
+inline std::pmr::memory_resource* set_limb_resource(std::pmr::memory_resource* resource) {
+	std::pmr::memory_resource* old = current_limb_resource();
+	current_limb_resource() = resource;
+	return old;
+}
+
+// Routes limb allocations of the current thread to a resource until the
+// end of the scope.
+class scoped_limb_resource {
+public:
+	explicit scoped_limb_resource(std::pmr::memory_resource* resource) : old_(set_limb_resource(resource)) {};
+
+	scoped_limb_resource(scoped_limb_resource const&) = delete;
+	scoped_limb_resource& operator=(scoped_limb_resource const&) = delete;
+
+	~scoped_limb_resource() {
+		set_limb_resource(old_);
+	}
+
+private:
+	std::pmr::memory_resource* old_;
+};
+
+// polymorphic_allocator that counts every array it hands out in
+// big_integer_stats::allocations, the first one of a buffer as well as
+// each reallocation when it grows.
+template<typename T>
+class counting_allocator : public std::pmr::polymorphic_allocator<T> {
+public:
+	counting_allocator(std::pmr::memory_resource* resource) noexcept : std::pmr::polymorphic_allocator<T>(resource) {}
+
+	template<typename U>
+	counting_allocator(counting_allocator<U> const& other) noexcept : std::pmr::polymorphic_allocator<T>(other.resource()) {}
+
+	T* allocate(size_t n) {
+		BIGINT_STATS_COUNT(allocations);
+		return std::pmr::polymorphic_allocator<T>::allocate(n);
+	}
+
+	// Like polymorphic_allocator, a copied container does not inherit the
+	// resource.
+	counting_allocator select_on_container_copy_construction() const {
+		return counting_allocator(std::pmr::get_default_resource());
+	}
+};
 
 class my_vector {
 public:
+	using allocator_type = counting_allocator<uint32_t>;
+
 	uint32_t reference_count;
-	std::vector<uint32_t> data;
+	std::vector<uint32_t, allocator_type> data;
+	// Hash of data shared by all owners of the buffer, zero while unknown.
+	std::atomic<uint64_t> hash;
 
-	my_vector() : reference_count(1) {};
-	my_vector(my_vector const& v) : reference_count(1), data(v.data) {};
-	explicit my_vector(std::vector<uint32_t> const& v) : reference_count(1), data(v) {};
-	my_vector(uint32_t* begin, uint32_t* end) : reference_count(1), data(begin, end) {};
+	explicit my_vector(allocator_type alloc) : reference_count(1), data(alloc), hash(0) {};
+	my_vector(my_vector const& v, allocator_type alloc) : reference_count(1), data(v.data, alloc), hash(0) {};
+	my_vector(uint32_t const* begin, uint32_t const* end, allocator_type alloc) : reference_count(1), data(begin, end, alloc), hash(0) {};
 
 	~my_vector() = default;
 
+	// Places a new buffer and its header in the given resource.
+	template<typename... Args>
+	static my_vector* create(std::pmr::memory_resource* resource, Args const&... args) {
+		BIGINT_STATS_COUNT(allocations);
+		void* place = resource->allocate(sizeof(my_vector), alignof(my_vector));
+		try {
+			return new(place) my_vector(args..., allocator_type(resource));
+		} catch (...) {
+			resource->deallocate(place, sizeof(my_vector), alignof(my_vector));
+			throw;
+		}
+	}
+
 	void delete_vector() {
 		if (reference_count == 1) {
-			delete this;
+			std::pmr::memory_resource* resource = data.get_allocator().resource();
+			this->~my_vector();
+			resource->deallocate(this, sizeof(my_vector), alignof(my_vector));
 		} else {
 			reference_count--;
 		}
@@ -0,0 +1,625 @@
+#include "number_theory.h"
+#include "limb_kernels.h"
+#include "limb_multiply.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+// Sieve of Eratosthenes over the odd numbers.
+std::vector<uint32_t> primes_up_to(uint32_t n) {
+	std::vector<uint32_t> primes;
+	if (n < 2) {
+		return primes;
+	}
+	primes.push_back(2);
+	std::vector<bool> composite(n / 2 + 1);
+	for (uint64_t i = 3; i <= n; i += 2) {
+		if (composite[i / 2]) {
+			continue;
+		}
+		primes.push_back(static_cast<uint32_t>(i));
+		for (uint64_t j = i * i; j <= n; j += 2 * i) {
+			composite[j / 2] = true;
+		}
+	}
+	return primes;
+}
+
+// Exponent of p in n! by Legendre's formula.
+uint32_t legendre(uint32_t n, uint32_t p) {
+	uint32_t result = 0;
+	while (n >= p) {
+		n /= p;
+		result += n;
+	}
+	return result;
+}
+
+// Packs consecutive factors into words of up to 64 bits, so that the
+// leaves of the product tree are not single-limb numbers.
+void append_packed(std::vector<big_integer>& out, std::vector<uint32_t> const& factors) {
+	uint64_t word = 1;
+	for (uint32_t factor : factors) {
+		if (word > UINT64_MAX / factor) {
+			out.push_back(word);
+			word = 1;
+		}
+		word *= factor;
+	}
+	if (word != 1) {
+		out.push_back(word);
+	}
+}
+
+// prod primes[i]^exponents[i] times 2^twos. Goes from the highest bit of
+// the exponents down: square what is there and multiply by the primes
+// whose exponent has the bit set.
+big_integer from_factorization(std::vector<uint32_t> const& primes, std::vector<uint32_t> const& exponents,
+                               uint32_t twos) {
+	uint32_t top = 0;
+	for (uint32_t e : exponents) {
+		top = std::max(top, e);
+	}
+	big_integer result = 1;
+	std::vector<uint32_t> factors;
+	std::vector<big_integer> packed;
+	for (uint32_t bit = 32; bit > 0; bit--) {
+		if ((top >> (bit - 1)) == 0) {
+			continue;
+		}
+		factors.clear();
+		for (size_t i = 0; i < primes.size(); i++) {
+			if (exponents[i] & (1u << (bit - 1))) {
+				factors.push_back(primes[i]);
+			}
+		}
+		packed.clear();
+		append_packed(packed, factors);
+		result *= result;
+		result *= product(packed.data(), packed.data() + packed.size());
+	}
+	return result <<= static_cast<int>(twos);
+}
+}
+
+big_integer factorial(uint32_t n) {
+	std::vector<uint32_t> primes = primes_up_to(n);
+	std::vector<uint32_t> exponents;
+	uint32_t twos = legendre(n, 2);
+	for (size_t i = 1; i < primes.size(); i++) {
+		exponents.push_back(legendre(n, primes[i]));
+	}
+	if (!primes.empty()) {
+		primes.erase(primes.begin());
+	}
+	return from_factorization(primes, exponents, twos);
+}
+
+// The exponent of p in C(n, k) is that of n! less those of k! and (n - k)!.
+big_integer binomial(uint32_t n, uint32_t k) {
+	if (k > n) {
+		return 0;
+	}
+	std::vector<uint32_t> primes = primes_up_to(n);
+	std::vector<uint32_t> odd_primes, exponents;
+	uint32_t twos = 0;
+	for (uint32_t p : primes) {
+		uint32_t e = legendre(n, p) - legendre(k, p) - legendre(n - k, p);
+		if (p == 2) {
+			twos = e;
+		} else if (e != 0) {
+			odd_primes.push_back(p);
+			exponents.push_back(e);
+		}
+	}
+	return from_factorization(odd_primes, exponents, twos);
+}
+
+big_integer primorial(uint32_t n) {
+	std::vector<big_integer> packed;
+	append_packed(packed, primes_up_to(n));
+	return product(packed.data(), packed.data() + packed.size());
+}
+
+// Primality tests on the limbs of odd values. Residues modulo n are kept
+// in Montgomery form as arrays of exactly n limbs, so a modular product is
+// one multiplication and one word-by-word reduction instead of a division.
+struct prime_testing {
+	// Odd primes below this bound are tried as divisors before any
+	// exponentiation; values below its square that survive are prime.
+	static constexpr uint32_t TRIAL_LIMIT = 1000;
+	// next_prime sieves a window of this many odd candidates at a time by
+	// the primes below SIEVE_LIMIT.
+	static constexpr size_t SIEVE_WINDOW = 4096;
+	static constexpr uint32_t SIEVE_LIMIT = 1u << 16u;
+
+	// Consecutive odd primes whose product fits in a limb, so that a single
+	// remainder pass over the value serves all of them.
+	struct prime_group {
+		limbs::divisor_1 product;
+		size_t first;
+		size_t last;
+	};
+
+	struct sieve_primes {
+		std::vector<uint32_t> primes;
+		std::vector<prime_group> groups;
+		size_t trial_groups = 0;
+	};
+
+	static sieve_primes build_sieve_primes() {
+		sieve_primes result;
+		result.primes = primes_up_to(SIEVE_LIMIT);
+		result.primes.erase(result.primes.begin());
+		for (size_t i = 0; i < result.primes.size();) {
+			uint32_t product = 1;
+			size_t last = i;
+			while (last < result.primes.size() && product <= UINT32_MAX / result.primes[last]) {
+				product *= result.primes[last++];
+			}
+			if (result.primes[i] < TRIAL_LIMIT) {
+				result.trial_groups++;
+			}
+			result.groups.push_back({limbs::divisor_1(product), i, last});
+			i = last;
+		}
+		return result;
+	}
+
+	static sieve_primes const& small_primes() {
+		static sieve_primes const result = build_sieve_primes();
+		return result;
+	}
+
+	class montgomery {
+	public:
+		explicit montgomery(big_integer const& modulus)
+			: n_(modulus.digits_.size()), m_(modulus.digits_.cbegin(), modulus.digits_.cend()), t_(2 * n_ + 1) {
+			// Newton's iteration doubles the correct low bits of the inverse,
+			// starting from 3 as m * m == 1 mod 8 for odd m.
+			uint32_t x = m_[0];
+			for (int i = 0; i < 4; i++) {
+				x *= 2 - m_[0] * x;
+			}
+			inv_ = 0 - x;
+			one_ = to_form(1);
+		}
+
+		size_t size() const {
+			return n_;
+		}
+
+		uint32_t const* one() const {
+			return one_.data();
+		}
+
+		// x R mod m for 0 <= x.
+		std::vector<uint32_t> to_form(big_integer const& x) const {
+			big_integer modulus;
+			modulus.assign_digits(m_.data(), n_, false);
+			big_integer reduced = (x << static_cast<int>(32 * n_)) % modulus;
+			std::vector<uint32_t> result(n_);
+			std::copy(reduced.digits_.cbegin(), reduced.digits_.cend(), result.begin());
+			return result;
+		}
+
+		bool equal(uint32_t const* a, uint32_t const* b) const {
+			return limbs::cmp_n(a, b, n_) == 0;
+		}
+
+		bool is_zero(uint32_t const* a) const {
+			return limbs::normalized_size(a, n_) == 0;
+		}
+
+		// r = a b / R mod m; r may alias either operand.
+		void mul(uint32_t* r, uint32_t const* a, uint32_t const* b) const {
+			uint32_t* t = t_.data();
+			limbs::mul(t, a, n_, b, n_);
+			// The carry out of each row goes into the limb above it, and what
+			// overflows from there is added along with the next row.
+			uint64_t extra = 0;
+			for (size_t i = 0; i < n_; i++) {
+				uint32_t carry = limbs::addmul_1(t + i, m_.data(), n_, t[i] * inv_);
+				extra += static_cast<uint64_t>(t[i + n_]) + carry;
+				t[i + n_] = static_cast<uint32_t>(extra);
+				extra >>= 32u;
+			}
+			t[2 * n_] = static_cast<uint32_t>(extra);
+			if (t[2 * n_] != 0 || limbs::cmp_n(t + n_, m_.data(), n_) >= 0) {
+				limbs::sub_n(r, t + n_, m_.data(), n_);
+			} else {
+				std::copy_n(t + n_, n_, r);
+			}
+		}
+
+		void add(uint32_t* r, uint32_t const* a, uint32_t const* b) const {
+			uint32_t carry = limbs::add_n(r, a, b, n_);
+			if (carry || limbs::cmp_n(r, m_.data(), n_) >= 0) {
+				limbs::sub_n(r, r, m_.data(), n_);
+			}
+		}
+
+		void sub(uint32_t* r, uint32_t const* a, uint32_t const* b) const {
+			if (limbs::sub_n(r, a, b, n_)) {
+				limbs::add_n(r, r, m_.data(), n_);
+			}
+		}
+
+		// r = a / 2 mod m, adding m first to an odd a.
+		void half(uint32_t* r, uint32_t const* a) const {
+			uint32_t carry = 0;
+			if (a[0] & 1u) {
+				carry = limbs::add_n(r, a, m_.data(), n_);
+				a = r;
+			}
+			limbs::rshift(r, a, n_, 1);
+			r[n_ - 1] |= carry << 31u;
+		}
+
+		// r = base^e with a fixed window of four exponent bits.
+		void pow(uint32_t* r, uint32_t const* base, big_integer const& e) const {
+			std::vector<uint32_t> table(16 * n_);
+			std::copy_n(one(), n_, table.data());
+			std::copy_n(base, n_, table.data() + n_);
+			for (size_t i = 2; i < 16; i++) {
+				mul(table.data() + i * n_, table.data() + (i - 1) * n_, base);
+			}
+			std::copy_n(one(), n_, r);
+			for (size_t i = e.digits_.size(); i > 0; i--) {
+				for (uint32_t shift = 32; shift > 0; shift -= 4) {
+					for (int k = 0; k < 4; k++) {
+						mul(r, r, r);
+					}
+					uint32_t window = (e.digits_[i - 1] >> (shift - 4)) & 15u;
+					if (window) {
+						mul(r, r, table.data() + window * n_);
+					}
+				}
+			}
+		}
+
+	private:
+		size_t n_;
+		std::vector<uint32_t> m_;
+		uint32_t inv_;
+		std::vector<uint32_t> one_;
+		mutable std::vector<uint32_t> t_;
+	};
+
+	static bool is_even(big_integer const& x) {
+		return x.digits_.empty() || (x.digits_[0] & 1u) == 0;
+	}
+
+	static uint32_t mod_small(big_integer const& x, limbs::divisor_1 const& d) {
+		return limbs::mod_1(x.digits_.cbegin(), x.digits_.size(), d);
+	}
+
+	static uint32_t mod_small(big_integer const& x, uint32_t d) {
+		return limbs::mod_1(x.digits_.cbegin(), x.digits_.size(), d);
+	}
+
+	// Smallest odd prime below TRIAL_LIMIT dividing x, zero if there is none.
+	static uint32_t trial_division(big_integer const& x) {
+		sieve_primes const& table = small_primes();
+		for (size_t g = 0; g < table.trial_groups; g++) {
+			prime_group const& group = table.groups[g];
+			uint32_t rem = mod_small(x, group.product);
+			for (size_t i = group.first; i < group.last; i++) {
+				if (rem % table.primes[i] == 0) {
+					return table.primes[i];
+				}
+			}
+		}
+		return 0;
+	}
+
+	static int jacobi(uint64_t a, uint64_t n) {
+		int result = 1;
+		a %= n;
+		while (a != 0) {
+			while (a % 2 == 0) {
+				a /= 2;
+				if (n % 8 == 3 || n % 8 == 5) {
+					result = -result;
+				}
+			}
+			std::swap(a, n);
+			if (a % 4 == 3 && n % 4 == 3) {
+				result = -result;
+			}
+			a %= n;
+		}
+		return n == 1 ? result : 0;
+	}
+
+	// (d / x) for a small d and an odd x by quadratic reciprocity.
+	static int jacobi(int64_t d, big_integer const& x) {
+		uint32_t x8 = x.digits_[0] & 7u;
+		int result = 1;
+		uint64_t a = d < 0 ? 0 - static_cast<uint64_t>(d) : static_cast<uint64_t>(d);
+		if (d < 0 && x8 % 4 == 3) {
+			result = -result;
+		}
+		while (a % 2 == 0) {
+			a /= 2;
+			if (x8 == 3 || x8 == 5) {
+				result = -result;
+			}
+		}
+		if (a == 1) {
+			return result;
+		}
+		if (a % 4 == 3 && x8 % 4 == 3) {
+			result = -result;
+		}
+		return result * jacobi(mod_small(x, static_cast<uint32_t>(a)), a);
+	}
+
+	static bool is_square(big_integer const& x) {
+		big_integer root = big_integer(1) << static_cast<int>((x.bit_length() + 1) / 2);
+		while (true) {
+			big_integer next = (root + x / root) >> 1;
+			if (next >= root) {
+				break;
+			}
+			root = next;
+		}
+		return root * root == x;
+	}
+
+	// Strong Fermat test: with x - 1 = d 2^s, base^d is 1 or one of the
+	// following s - 1 squarings hits -1.
+	static bool strong_probable_prime(montgomery const& ctx, big_integer const& x, uint32_t const* base) {
+		size_t n = ctx.size();
+		big_integer x_minus_1 = x - 1;
+		size_t s = x_minus_1.ctz();
+		std::vector<uint32_t> y(n), minus_one(n);
+		ctx.sub(minus_one.data(), std::vector<uint32_t>(n).data(), ctx.one());
+		ctx.pow(y.data(), base, x_minus_1 >> static_cast<int>(s));
+		if (ctx.equal(y.data(), ctx.one()) || ctx.equal(y.data(), minus_one.data())) {
+			return true;
+		}
+		for (size_t r = 1; r < s; r++) {
+			ctx.mul(y.data(), y.data(), y.data());
+			if (ctx.equal(y.data(), minus_one.data())) {
+				return true;
+			}
+			if (ctx.equal(y.data(), ctx.one())) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	// Strong Lucas test with P = 1 and Q = (1 - D) / 4 for the first D of
+	// 5, -7, 9, -11, ... with (D / x) = -1. With x + 1 = d 2^s, U_d is zero or
+	// one of V_d, V_2d, ..., V_(d 2^(s-1)) is.
+	static bool strong_lucas_probable_prime(montgomery const& ctx, big_integer const& x) {
+		int64_t d = 5;
+		for (int tries = 0;; tries++) {
+			int j = jacobi(d, x);
+			if (j == -1) {
+				break;
+			}
+			if (j == 0) {
+				return false;
+			}
+			if (tries == 10 && is_square(x)) {
+				return false;
+			}
+			d = d > 0 ? -(d + 2) : -d + 2;
+		}
+		auto residue = [&](int64_t v) {
+			big_integer value = v;
+			if (value < 0) {
+				value += x;
+			}
+			return ctx.to_form(value);
+		};
+		size_t n = ctx.size();
+		std::vector<uint32_t> dm = residue(d), q = residue((1 - d) / 4);
+		std::vector<uint32_t> u(ctx.one(), ctx.one() + n), v = u, qk = q, tmp(n);
+
+		big_integer x_plus_1 = x + 1;
+		size_t s = x_plus_1.ctz();
+		big_integer e = x_plus_1 >> static_cast<int>(s);
+		for (size_t bit = e.bit_length() - 1; bit > 0; bit--) {
+			ctx.mul(u.data(), u.data(), v.data());
+			ctx.mul(v.data(), v.data(), v.data());
+			ctx.sub(v.data(), v.data(), qk.data());
+			ctx.sub(v.data(), v.data(), qk.data());
+			ctx.mul(qk.data(), qk.data(), qk.data());
+			if (e.test_bit(bit - 1)) {
+				ctx.mul(tmp.data(), dm.data(), u.data());
+				ctx.add(u.data(), u.data(), v.data());
+				ctx.half(u.data(), u.data());
+				ctx.add(v.data(), v.data(), tmp.data());
+				ctx.half(v.data(), v.data());
+				ctx.mul(qk.data(), qk.data(), q.data());
+			}
+		}
+		if (ctx.is_zero(u.data()) || ctx.is_zero(v.data())) {
+			return true;
+		}
+		for (size_t r = 1; r < s; r++) {
+			ctx.mul(v.data(), v.data(), v.data());
+			ctx.sub(v.data(), v.data(), qk.data());
+			ctx.sub(v.data(), v.data(), qk.data());
+			if (ctx.is_zero(v.data())) {
+				return true;
+			}
+			ctx.mul(qk.data(), qk.data(), qk.data());
+		}
+		return false;
+	}
+
+	// x is odd and has no prime factor below TRIAL_LIMIT.
+	static bool probable_prime(big_integer const& x, size_t rounds) {
+		if (x < TRIAL_LIMIT * TRIAL_LIMIT) {
+			return true;
+		}
+		montgomery ctx(x);
+		if (!strong_probable_prime(ctx, x, ctx.to_form(2).data())) {
+			return false;
+		}
+		if (!strong_lucas_probable_prime(ctx, x)) {
+			return false;
+		}
+		std::mt19937 rng(static_cast<uint32_t>(x.digits_[0]));
+		big_integer span = x - 3;
+		for (size_t round = 0; round < rounds; round++) {
+			big_integer base;
+			base.digits_.reset(x.digits_.size());
+			std::generate(base.digits_.begin(), base.digits_.end(), rng);
+			base.normalize();
+			base = base % span + 2;
+			if (!strong_probable_prime(ctx, x, ctx.to_form(base).data())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool is_probable_prime(big_integer const& x, size_t rounds) {
+		if (x < 2) {
+			return false;
+		}
+		if (is_even(x)) {
+			return x == 2;
+		}
+		uint32_t factor = trial_division(x);
+		if (factor != 0) {
+			return x == factor;
+		}
+		return probable_prime(x, rounds);
+	}
+
+	// Crosses out the multiples of the small primes among the odd
+	// candidates start + 2j of a window, but not the small primes
+	// themselves.
+	static big_integer next_prime(big_integer const& x) {
+		if (x < 2) {
+			return 2;
+		}
+		big_integer start = x + 1;
+		if (is_even(start)) {
+			start += 1;
+		}
+		sieve_primes const& table = small_primes();
+		std::vector<bool> composite(SIEVE_WINDOW);
+		while (true) {
+			std::fill(composite.begin(), composite.end(), false);
+			for (prime_group const& group : table.groups) {
+				uint32_t rem = mod_small(start, group.product);
+				for (size_t i = group.first; i < group.last; i++) {
+					uint64_t p = table.primes[i];
+					uint64_t j = (p - rem % p) % p;
+					if (j % 2) {
+						j += p;
+					}
+					j /= 2;
+					if (start <= p) {
+						j += p;
+					}
+					for (; j < SIEVE_WINDOW; j += p) {
+						composite[j] = true;
+					}
+				}
+			}
+			for (size_t j = 0; j < SIEVE_WINDOW; j++) {
+				if (!composite[j]) {
+					big_integer candidate = start + 2 * j;
+					if (is_probable_prime(candidate, 0)) {
+						return candidate;
+					}
+				}
+			}
+			start += 2 * SIEVE_WINDOW;
+		}
+	}
+};
+
+bool is_probable_prime(big_integer const& x, size_t rounds) {
+	return prime_testing::is_probable_prime(x, rounds);
+}
+
+big_integer next_prime(big_integer const& x) {
+	return prime_testing::next_prime(x);
+}
+
+// Lehmer's algorithm, Knuth's Algorithm L in TAOCP 4.5.2: Euclid is run on
+// the leading 62 bits of both operands for as long as the quotients it
+// finds are certain to be those of the full values, and only the 2x2
+// matrix of cofactors is applied to the full values, one pass for about
+// a limb of progress instead of one per quotient.
+struct lehmer_gcd {
+	static constexpr size_t LEADING_BITS = 62;
+
+	// Bits [shift, shift + 62) of a value below 2^(shift + 62).
+	static uint64_t bits_from(big_integer const& x, size_t shift) {
+		size_t word = shift / 32, bit = shift % 32, n = x.digits_.size();
+		uint32_t const* d = x.digits_.cbegin();
+		uint64_t low = word < n ? d[word] : 0;
+		if (word + 1 < n) {
+			low |= static_cast<uint64_t>(d[word + 1]) << 32u;
+		}
+		uint64_t high = word + 2 < n ? d[word + 2] : 0;
+		return bit == 0 ? low : (low >> bit) | (high << (64 - bit));
+	}
+
+	static uint64_t euclid(uint64_t a, uint64_t b) {
+		while (b != 0) {
+			uint64_t t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+
+	// a >= b >= 0 on entry.
+	static big_integer gcd(big_integer a, big_integer b) {
+		while (b.bit_length() > 64) {
+			size_t shift = a.bit_length() - LEADING_BITS;
+			int64_t x = static_cast<int64_t>(bits_from(a, shift)), y = static_cast<int64_t>(bits_from(b, shift));
+			int64_t A = 1, B = 0, C = 0, D = 1;
+			while (y + C != 0 && y + D != 0) {
+				int64_t q = (x + A) / (y + C);
+				if (q != (x + B) / (y + D)) {
+					break;
+				}
+				int64_t t = A - q * C;
+				A = C;
+				C = t;
+				t = B - q * D;
+				B = D;
+				D = t;
+				t = x - q * y;
+				x = y;
+				y = t;
+			}
+			if (B == 0) {
+				a %= b;
+				swap(a, b);
+			} else {
+				big_integer next_a = a * A + b * B;
+				b = a * C + b * D;
+				a = std::move(next_a);
+			}
+		}
+		if (b == 0) {
+			return a;
+		}
+		a %= b;
+		return big_integer(euclid(b.low_u64(), a.low_u64()));
+	}
+};
+
+big_integer gcd(big_integer const& x, big_integer const& y) {
+	big_integer a = abs(x), b = abs(y);
+	if (a < b) {
+		swap(a, b);
+	}
+	return lehmer_gcd::gcd(std::move(a), std::move(b));
+}
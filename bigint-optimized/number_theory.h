@@ -0,0 +1,27 @@
+#ifndef BIGINT_NUMBER_THEORY_H
+#define BIGINT_NUMBER_THEORY_H
+
+#include <cstdint>
+#include "big_integer.h"
+
+// Built from the prime factorization: every prime up to n gets its
+// exponent, the odd ones are multiplied together by product trees, one per
+// bit of the exponents, and the power of two is a final shift.
+big_integer factorial(uint32_t n);
+// Zero for k > n.
+big_integer binomial(uint32_t n, uint32_t k);
+// Product of all primes up to n.
+big_integer primorial(uint32_t n);
+
+// Greatest common divisor of the magnitudes, zero only for two zeros.
+// Lehmer's algorithm, a multiple-precision step per limb of progress.
+big_integer gcd(big_integer const& a, big_integer const& b);
+
+// Baillie-PSW test, a strong Fermat test to base 2 and a strong Lucas test,
+// followed by the given number of Miller-Rabin rounds with random bases.
+// No composite passing BPSW alone is known. False for values below 2.
+bool is_probable_prime(big_integer const& x, size_t rounds = 0);
+// Smallest probable prime greater than x.
+big_integer next_prime(big_integer const& x);
+
+#endif //BIGINT_NUMBER_THEORY_H
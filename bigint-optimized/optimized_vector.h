@@ -2,21 +2,39 @@
 #define BIGINT_OPTIMIZED_VECTOR_H
 
 #include <algorithm>
+#include <cstddef>
 #include "my_vector.h"
 
 class optimized_vector {
 public:
 	optimized_vector() : is_small_(true), size_(0) {};
 
-	optimized_vector(optimized_vector const& other) : is_small_(other.is_small_), size_(other.size_) {
+	optimized_vector(optimized_vector const& other) : is_small_(other.is_small_), is_view_(other.is_view_), size_(other.size_) {
 		if (is_small_) {
 			std::copy_n(other.static_vec, size_, static_vec);
+		} else if (is_view_) {
+			view_vec = other.view_vec;
 		} else {
 			other.reference_counter()++;
 			dynamic_vec = other.dynamic_vec;
 		}
 	};
 
+	// Takes over the buffer of other, which is left empty.
+	optimized_vector(optimized_vector&& other) noexcept {
+		take(other);
+	}
+
+	optimized_vector& operator=(optimized_vector&& other) noexcept {
+		if (&other != this) {
+			if (is_shared()) {
+				dynamic_vec->delete_vector();
+			}
+			take(other);
+		}
+		return *this;
+	}
+
 	optimized_vector& operator=(optimized_vector const& other) {
 		if (&other != this) {
 			optimized_vector safe(other);
@@ -26,11 +44,26 @@ public:
 	}
 
 	~optimized_vector() {
-		if (!is_small_) {
+		if (is_shared()) {
 			dynamic_vec->delete_vector();
 		}
 	}
 
+	// Refers to limbs owned by someone else until the first write, which
+	// copies them. The limbs must outlive every copy that still borrows them.
+	static optimized_vector borrow(uint32_t const* data, size_t size) {
+		optimized_vector result;
+		result.is_small_ = false;
+		result.is_view_ = true;
+		result.view_vec = data;
+		result.size_ = size;
+		return result;
+	}
+
+	bool is_borrowed() const {
+		return is_view_;
+	}
+
 	bool empty() const {
 		return size_ == 0;
 	}
@@ -40,11 +73,11 @@ public:
 	}
 
 	size_t capacity() const {
-		return is_small_ ? SMALL_SZ : dynamic_vec->data.capacity();
+		return is_small_ ? SMALL_SZ : is_view_ ? size_ : dynamic_vec->data.capacity();
 	}
 
 	uint32_t const& operator[](size_t i) const {
-		return is_small_ ? static_vec[i] : dynamic_vec->data[i];
+		return begin()[i];
 	}
 
 	uint32_t const& back() const {
@@ -83,7 +116,7 @@ public:
 	}
 
 	uint32_t const* begin() const {
-		return is_small_ ? static_vec : dynamic_vec->data.data();
+		return is_small_ ? static_vec : is_view_ ? view_vec : dynamic_vec->data.data();
 	}
 
 	uint32_t* begin() {
@@ -95,22 +128,66 @@ public:
 		return begin() + size_;
 	}
 
+	uint32_t const* cbegin() const {
+		return begin();
+	}
+
+	uint32_t const* cend() const {
+		return end();
+	}
+
 	uint32_t* end() {
 		return begin() + size_;
 	}
 
-	void insert(uint32_t* begin_, size_t count, uint32_t x) {
+	// Hash of the contents cached in a shared buffer; zero if not cached.
+	uint64_t cached_hash() const {
+		return is_shared() ? dynamic_vec->hash.load(std::memory_order_relaxed) : 0;
+	}
+
+	void cache_hash(uint64_t hash) const {
+		if (is_shared()) {
+			dynamic_vec->hash.store(hash, std::memory_order_relaxed);
+		}
+	}
+
+	void resize(size_t n) {
 		make_unique();
-		if (size_ + count > SMALL_SZ) {
+		if (n > SMALL_SZ) {
 			make_big();
-			dynamic_vec->data.insert(dynamic_vec->data.begin() + (begin_ - begin()), count, x);
+		}
+		if (is_small_) {
+			std::fill(static_vec + std::min(size_, n), static_vec + n, 0);
 		} else {
-			for (uint32_t* it = end() - 1; it >= begin_ + count; it--) {
-				*it = *(it - count);
-			}
-			for (uint32_t* it = begin_; it != begin_ + count; it++) {
-				*it = x;
+			dynamic_vec->data.resize(n);
+		}
+		size_ = n;
+	}
+
+	// Resizes to n limbs whose values are left to the caller; unlike resize()
+	// it does not copy a buffer that is shared with other owners.
+	void reset(size_t n) {
+		if (is_view_ || (is_shared() && reference_counter() > 1)) {
+			if (!is_view_) {
+				reference_counter()--;
 			}
+			is_small_ = true;
+			is_view_ = false;
+			size_ = 0;
+		}
+		resize(n);
+	}
+
+	void insert(uint32_t* begin_, size_t count, uint32_t x) {
+		size_t index = begin_ - begin();
+		if (size_ + count > SMALL_SZ) {
+			make_big();
+		}
+		if (!is_small_) {
+			dynamic_vec->data.insert(dynamic_vec->data.begin() + index, count, x);
+		} else {
+			std::copy_backward(static_vec + index, static_vec + size_, static_vec + size_ + count);
+			std::fill_n(static_vec + index, count, x);
 		}
 		size_ += count;
 	}
@@ -118,7 +195,7 @@ public:
 
 	void erase(uint32_t* begin_, uint32_t* end_) {
 		make_unique();
-		ptrdiff_t count = end_ - begin_;
+		std::ptrdiff_t count = end_ - begin_;
 		if (!is_small_) {
 			dynamic_vec->data.erase(dynamic_vec->data.begin() + (begin_ - begin()),
 				dynamic_vec->data.begin() + (end_ - begin()));
@@ -133,46 +210,80 @@ public:
 private:
 	static constexpr size_t SMALL_SZ = 5;
 	bool is_small_ = true;
+	bool is_view_ = false;
 	size_t size_ = 0;
 	union {
 		uint32_t static_vec[SMALL_SZ];
 		my_vector* dynamic_vec;
+		uint32_t const* view_vec;
 	};
 
+	bool is_shared() const {
+		return !is_small_ && !is_view_;
+	}
+
 	uint32_t& reference_counter() const {
 		return dynamic_vec->reference_count;
 	}
 
-	void swap_small_big(optimized_vector& other) {
-		my_vector* old_vector = other.dynamic_vec;
-		std::copy_n(static_vec, size_, other.static_vec);
-		dynamic_vec = old_vector;
+	// Swaps the union byte by byte, which covers every pair of states.
+	void swap(optimized_vector& other) {
+		static_assert(sizeof(static_vec) >= sizeof(my_vector*), "pointers must fit in the small buffer");
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(static_vec);
+		std::swap_ranges(bytes, bytes + sizeof(static_vec), reinterpret_cast<unsigned char*>(other.static_vec));
+		std::swap(size_, other.size_);
+		std::swap(is_small_, other.is_small_);
+		std::swap(is_view_, other.is_view_);
 	}
 
-	void swap(optimized_vector& other) {
-		if (is_small_ && other.is_small_) {
-			std::swap(static_vec, other.static_vec);
-		} else if (!is_small_ && !other.is_small_) {
-			std::swap(dynamic_vec, other.dynamic_vec);
-		} else if (is_small_) {
-			swap_small_big(other);
+	// Moves the contents of other here and leaves it empty; whatever was
+	// here must already be released.
+	void take(optimized_vector& other) {
+		is_small_ = other.is_small_;
+		is_view_ = other.is_view_;
+		size_ = other.size_;
+		if (is_small_) {
+			std::copy_n(other.static_vec, size_, static_vec);
+		} else if (is_view_) {
+			view_vec = other.view_vec;
 		} else {
-			other.swap_small_big(*this);
+			dynamic_vec = other.dynamic_vec;
 		}
-		std::swap(size_, other.size_);
-		std::swap(is_small_, other.is_small_);
+		other.is_small_ = true;
+		other.is_view_ = false;
+		other.size_ = 0;
 	}
 
+	// Called before every write, so it also drops the cached hash and turns
+	// borrowed limbs into owned ones.
 	void make_unique() {
-		if (!is_small_ && reference_counter() > 1) {
-			reference_counter()--;
-			dynamic_vec = new my_vector(*dynamic_vec);
+		if (is_view_) {
+			BIGINT_STATS_COUNT(cow_copies);
+			uint32_t const* view = view_vec;
+			is_view_ = false;
+			if (size_ <= SMALL_SZ) {
+				is_small_ = true;
+				std::copy_n(view, size_, static_vec);
+			} else {
+				dynamic_vec = my_vector::create(get_limb_resource(), view, view + size_);
+			}
+		} else if (!is_small_) {
+			if (reference_counter() > 1) {
+				BIGINT_STATS_COUNT(cow_copies);
+				reference_counter()--;
+				// The copy goes where the shared buffer is, not into whatever
+				// resource is current: the value may well outlive the latter.
+				dynamic_vec = my_vector::create(dynamic_vec->data.get_allocator().resource(), *dynamic_vec);
+			} else {
+				dynamic_vec->hash.store(0, std::memory_order_relaxed);
+			}
 		}
 	}
 
 	void make_big() {
 		if (is_small_) {
-			dynamic_vec = new my_vector(static_vec, static_vec + size_);
+			BIGINT_STATS_COUNT(promotions);
+			dynamic_vec = my_vector::create(get_limb_resource(), static_vec, static_vec + size_);
 			is_small_ = false;
 		}
 	}
@@ -0,0 +1,93 @@
+#ifndef BIGINT_SCRATCH_ARENA_H
+#define BIGINT_SCRATCH_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Per-thread stack of limbs for temporaries of the arithmetic kernels.
+// Memory is kept in a list of blocks that are never moved, so growing the
+// arena does not invalidate limbs handed out by outer frames. Once the
+// arena is warm, taking limbs from it never touches the heap.
+class scratch_arena {
+public:
+	struct mark {
+		size_t block;
+		size_t offset;
+	};
+
+	static scratch_arena& local() {
+		static thread_local scratch_arena arena;
+		return arena;
+	}
+
+	uint32_t* allocate(size_t n) {
+		if (blocks_.empty() || offset_ + n > blocks_[block_].size) {
+			next_block(n);
+		}
+		uint32_t* result = blocks_[block_].data.get() + offset_;
+		offset_ += n;
+		return result;
+	}
+
+	mark get_mark() const {
+		return {block_, offset_};
+	}
+
+	void release(mark m) {
+		block_ = m.block;
+		offset_ = m.offset;
+	}
+
+private:
+	static constexpr size_t MIN_BLOCK_SZ = 1024;
+
+	struct block {
+		std::unique_ptr<uint32_t[]> data;
+		size_t size;
+	};
+
+	std::vector<block> blocks_;
+	size_t block_ = 0;
+	size_t offset_ = 0;
+
+	void next_block(size_t n) {
+		size_t next = blocks_.empty() ? 0 : block_ + 1;
+		if (next == blocks_.size() || blocks_[next].size < n) {
+			size_t size = std::max(n, blocks_.empty() ? MIN_BLOCK_SZ : 2 * blocks_.back().size);
+			block fresh = {std::unique_ptr<uint32_t[]>(new uint32_t[size]), size};
+			if (next == blocks_.size()) {
+				blocks_.push_back(std::move(fresh));
+			} else {
+				blocks_[next] = std::move(fresh);
+			}
+		}
+		block_ = next;
+		offset_ = 0;
+	}
+};
+
+// Takes limbs from the thread's scratch arena and gives all of them back
+// when it goes out of scope.
+class scratch_frame {
+public:
+	scratch_frame() : arena_(scratch_arena::local()), mark_(arena_.get_mark()) {};
+
+	scratch_frame(scratch_frame const&) = delete;
+	scratch_frame& operator=(scratch_frame const&) = delete;
+
+	~scratch_frame() {
+		arena_.release(mark_);
+	}
+
+	uint32_t* allocate(size_t n) {
+		return arena_.allocate(n);
+	}
+
+private:
+	scratch_arena& arena_;
+	scratch_arena::mark mark_;
+};
+#endif //BIGINT_SCRATCH_ARENA_H
@@ -0,0 +1,161 @@
+#include "serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+void store_header(uint8_t* out, uint64_t header) {
+	for (size_t i = 0; i < SERIALIZED_HEADER_SZ; i++) {
+		out[i] = static_cast<uint8_t>(header >> (8 * i));
+	}
+}
+
+uint64_t load_header(uint8_t const* in) {
+	uint64_t header = 0;
+	for (size_t i = 0; i < SERIALIZED_HEADER_SZ; i++) {
+		header |= static_cast<uint64_t>(in[i]) << (8 * i);
+	}
+	return header;
+}
+
+void store_limbs(uint8_t* out, uint32_t const* limbs, size_t n) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	std::memcpy(out, limbs, n * sizeof(uint32_t));
+#else
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = 0; j < sizeof(uint32_t); j++) {
+			out[i * sizeof(uint32_t) + j] = static_cast<uint8_t>(limbs[i] >> (8 * j));
+		}
+	}
+#endif
+}
+
+void load_limbs(uint32_t* limbs, uint8_t const* in, size_t n) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	std::memcpy(limbs, in, n * sizeof(uint32_t));
+#else
+	for (size_t i = 0; i < n; i++) {
+		limbs[i] = 0;
+		for (size_t j = 0; j < sizeof(uint32_t); j++) {
+			limbs[i] |= static_cast<uint32_t>(in[i * sizeof(uint32_t) + j]) << (8 * j);
+		}
+	}
+#endif
+}
+
+// Size of the record whose header starts at in, or 0 if it cannot fit in
+// memory at all.
+size_t record_size(uint8_t const* in) {
+	uint64_t count = load_header(in) >> 1u;
+	if (count > (SIZE_MAX - SERIALIZED_HEADER_SZ) / sizeof(uint32_t)) {
+		return 0;
+	}
+	return SERIALIZED_HEADER_SZ + static_cast<size_t>(count) * sizeof(uint32_t);
+}
+
+[[noreturn]] void truncated() {
+	throw std::runtime_error("Truncated big_integer record");
+}
+}
+
+size_t serialized_size(big_integer const& a) {
+	return SERIALIZED_HEADER_SZ + a.digits_.size() * sizeof(uint32_t);
+}
+
+size_t serialize(big_integer const& a, uint8_t* out) {
+	size_t count = a.digits_.size();
+	store_header(out, (static_cast<uint64_t>(count) << 1u) | a.sign_);
+	store_limbs(out + SERIALIZED_HEADER_SZ, a.digits_.cbegin(), count);
+	return SERIALIZED_HEADER_SZ + count * sizeof(uint32_t);
+}
+
+void serialize(big_integer const& a, std::vector<uint8_t>& out) {
+	size_t offset = out.size();
+	out.resize(offset + serialized_size(a));
+	serialize(a, out.data() + offset);
+}
+
+size_t deserialize(byte_span in, big_integer& out) {
+	if (in.size < SERIALIZED_HEADER_SZ) {
+		truncated();
+	}
+	size_t size = record_size(in.data);
+	if (size == 0 || size > in.size) {
+		truncated();
+	}
+	size_t count = (size - SERIALIZED_HEADER_SZ) / sizeof(uint32_t);
+	out.digits_.reset(count);
+	load_limbs(out.digits_.begin(), in.data + SERIALIZED_HEADER_SZ, count);
+	out.sign_ = load_header(in.data) & 1u;
+	out.normalize();
+	return size;
+}
+
+big_integer deserialize(byte_span in) {
+	big_integer result;
+	deserialize(in, result);
+	return result;
+}
+
+big_integer_writer::big_integer_writer(std::ostream& out, size_t buffer_size)
+	: out_(out), buffer_(std::max(buffer_size, SERIALIZED_HEADER_SZ)) {}
+
+big_integer_writer::~big_integer_writer() {
+	flush();
+}
+
+void big_integer_writer::write(big_integer const& a) {
+	size_t size = serialized_size(a);
+	if (used_ + size > buffer_.size()) {
+		flush();
+		if (size > buffer_.size()) {
+			buffer_.resize(size);
+		}
+	}
+	used_ += serialize(a, buffer_.data() + used_);
+}
+
+void big_integer_writer::flush() {
+	out_.write(reinterpret_cast<char const*>(buffer_.data()), static_cast<std::streamsize>(used_));
+	used_ = 0;
+}
+
+big_integer_reader::big_integer_reader(std::istream& in, size_t buffer_size)
+	: in_(in), buffer_(std::max(buffer_size, SERIALIZED_HEADER_SZ)) {}
+
+bool big_integer_reader::fill(size_t n) {
+	if (end_ - begin_ >= n) {
+		return true;
+	}
+	std::copy(buffer_.begin() + begin_, buffer_.begin() + end_, buffer_.begin());
+	end_ -= begin_;
+	begin_ = 0;
+	// The buffer grows no faster than bytes arrive, so a header claiming
+	// more limbs than the stream holds costs at most twice what is there.
+	while (end_ < n && in_) {
+		if (end_ == buffer_.size()) {
+			buffer_.resize(std::min(n, 2 * buffer_.size()));
+		}
+		in_.read(reinterpret_cast<char*>(buffer_.data() + end_), static_cast<std::streamsize>(buffer_.size() - end_));
+		end_ += static_cast<size_t>(in_.gcount());
+	}
+	return end_ >= n;
+}
+
+bool big_integer_reader::read(big_integer& a) {
+	if (!fill(SERIALIZED_HEADER_SZ)) {
+		if (begin_ == end_) {
+			return false;
+		}
+		truncated();
+	}
+	size_t size = record_size(buffer_.data() + begin_);
+	if (size == 0 || !fill(size)) {
+		truncated();
+	}
+	begin_ += deserialize({buffer_.data() + begin_, size}, a);
+	return true;
+}
@@ -0,0 +1,70 @@
+#ifndef BIGINT_SERIALIZATION_H
+#define BIGINT_SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "big_integer.h"
+
+// Binary format of one value: a little-endian 64-bit header holding
+// (limb count << 1) | sign, followed by that many little-endian 32-bit
+// limbs, most significant limb nonzero. Values are simply concatenated in
+// a stream, so every record starts at a multiple of four bytes.
+
+struct byte_span {
+	uint8_t const* data;
+	size_t size;
+};
+
+size_t const SERIALIZED_HEADER_SZ = 8;
+
+size_t serialized_size(big_integer const& a);
+
+// Writes serialized_size(a) bytes to out and returns their count.
+size_t serialize(big_integer const& a, uint8_t* out);
+// Appends the record to out.
+void serialize(big_integer const& a, std::vector<uint8_t>& out);
+
+// Reads one record from the front of in and returns the number of bytes it
+// took. Throws std::runtime_error if in holds less than a whole record.
+size_t deserialize(byte_span in, big_integer& out);
+big_integer deserialize(byte_span in);
+
+// Buffered record writer; flushes on destruction.
+class big_integer_writer {
+public:
+	explicit big_integer_writer(std::ostream& out, size_t buffer_size = 1 << 20);
+
+	big_integer_writer(big_integer_writer const&) = delete;
+	big_integer_writer& operator=(big_integer_writer const&) = delete;
+
+	~big_integer_writer();
+
+	void write(big_integer const& a);
+	void flush();
+
+private:
+	std::ostream& out_;
+	std::vector<uint8_t> buffer_;
+	size_t used_ = 0;
+};
+
+// Buffered record reader.
+class big_integer_reader {
+public:
+	explicit big_integer_reader(std::istream& in, size_t buffer_size = 1 << 20);
+
+	// Returns false at the end of the stream. Throws std::runtime_error if
+	// the stream ends in the middle of a record.
+	bool read(big_integer& a);
+
+private:
+	std::istream& in_;
+	std::vector<uint8_t> buffer_;
+	size_t begin_ = 0;
+	size_t end_ = 0;
+
+	bool fill(size_t n);
+};
+#endif //BIGINT_SERIALIZATION_H
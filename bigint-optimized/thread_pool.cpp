@@ -0,0 +1,95 @@
+#include "thread_pool.h"
+
+namespace {
+thread_local thread_pool* worker_pool = nullptr;
+thread_local size_t worker_index = 0;
+}
+
+// Without workers there is still a queue, and the tasks are run by the
+// threads waiting for them.
+thread_pool::thread_pool(size_t workers) : pending_(0), next_queue_(0), stop_(false) {
+	for (size_t i = 0; i < std::max(workers, size_t(1)); i++) {
+		queues_.push_back(std::make_unique<queue>());
+	}
+	for (size_t i = 0; i < workers; i++) {
+		workers_.emplace_back([this, i] { work(i); });
+	}
+}
+
+thread_pool::~thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+thread_pool& thread_pool::global() {
+	static thread_pool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	return pool;
+}
+
+void thread_pool::submit(std::function<void()> task) {
+	size_t index = worker_pool == this ? worker_index : next_queue_++ % queues_.size();
+	{
+		std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+		queues_[index]->tasks.push_back(std::move(task));
+	}
+	pending_++;
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+	}
+	wake_.notify_one();
+}
+
+// Looks at the queue of index first and then at all the others. A worker
+// takes the newest task of its own queue and the oldest one of the others.
+bool thread_pool::take(size_t first, std::function<void()>& task) {
+	bool own = worker_pool == this && worker_index == first;
+	for (size_t k = 0; k < queues_.size(); k++) {
+		queue& q = *queues_[(first + k) % queues_.size()];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (q.tasks.empty()) {
+			continue;
+		}
+		if (k == 0 && own) {
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+		} else {
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+		pending_--;
+		return true;
+	}
+	return false;
+}
+
+bool thread_pool::run_one() {
+	std::function<void()> task;
+	if (!take(worker_pool == this ? worker_index : 0, task)) {
+		return false;
+	}
+	task();
+	return true;
+}
+
+void thread_pool::work(size_t index) {
+	worker_pool = this;
+	worker_index = index;
+	while (true) {
+		std::function<void()> task;
+		if (take(index, task)) {
+			task();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleep_mutex_);
+		wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+		if (stop_ && pending_ == 0) {
+			return;
+		}
+	}
+}
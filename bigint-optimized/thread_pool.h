@@ -0,0 +1,146 @@
+#ifndef BIGINT_THREAD_POOL_H
+#define BIGINT_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of threads a single big_integer operation may keep busy when
+// called from the current thread; 1, the default, runs everything serially.
+inline size_t& current_thread_limit() {
+	static thread_local size_t limit = 1;
+	return limit;
+}
+
+inline size_t get_thread_limit() {
+	return current_thread_limit();
+}
+
+// Returns the previous limit. Zero stands for one thread per core.
+inline size_t set_thread_limit(size_t limit) {
+	size_t old = current_thread_limit();
+	current_thread_limit() = limit ? limit : std::max(std::thread::hardware_concurrency(), 1u);
+	return old;
+}
+
+// Limits the operations of the current thread until the end of the scope.
+class scoped_thread_limit {
+public:
+	explicit scoped_thread_limit(size_t limit) : old_(set_thread_limit(limit)) {};
+
+	scoped_thread_limit(scoped_thread_limit const&) = delete;
+	scoped_thread_limit& operator=(scoped_thread_limit const&) = delete;
+
+	~scoped_thread_limit() {
+		current_thread_limit() = old_;
+	}
+
+private:
+	size_t old_;
+};
+
+// Work-stealing pool for fork-join parallelism. Every worker owns a queue;
+// tasks submitted from a worker go to its own queue, which it drains from
+// the back, while idle workers steal from the front of the others. Threads
+// waiting for a task_group run queued tasks instead of blocking, so nested
+// groups never starve the pool.
+class thread_pool {
+public:
+	explicit thread_pool(size_t workers);
+	~thread_pool();
+
+	thread_pool(thread_pool const&) = delete;
+	thread_pool& operator=(thread_pool const&) = delete;
+
+	// Shared pool with a worker for every core but the calling one.
+	static thread_pool& global();
+
+	size_t size() const {
+		return workers_.size();
+	}
+
+	void submit(std::function<void()> task);
+
+	// Runs one queued task on the calling thread, returns false if there
+	// was none.
+	bool run_one();
+
+private:
+	struct queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<size_t> pending_;
+	std::atomic<size_t> next_queue_;
+	std::mutex sleep_mutex_;
+	std::condition_variable wake_;
+	bool stop_;
+
+	bool take(size_t first, std::function<void()>& task);
+	void work(size_t index);
+};
+
+// Tasks forked from one place and joined together. The first exception
+// thrown by a task is rethrown from wait().
+class task_group {
+public:
+	explicit task_group(thread_pool& pool) : pool_(pool), running_(0) {};
+
+	task_group(task_group const&) = delete;
+	task_group& operator=(task_group const&) = delete;
+
+	~task_group() {
+		join();
+	}
+
+	template<typename F>
+	void run(F&& f) {
+		running_++;
+		pool_.submit([this, f = std::forward<F>(f)]() mutable {
+			try {
+				f();
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(error_mutex_);
+				if (!error_) {
+					error_ = std::current_exception();
+				}
+			}
+			running_--;
+		});
+	}
+
+	void wait() {
+		join();
+		if (error_) {
+			std::exception_ptr error = error_;
+			error_ = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+private:
+	thread_pool& pool_;
+	std::atomic<size_t> running_;
+	std::mutex error_mutex_;
+	std::exception_ptr error_;
+
+	void join() {
+		while (running_ > 0) {
+			if (!pool_.run_one()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+};
+#endif //BIGINT_THREAD_POOL_H
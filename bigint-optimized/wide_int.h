@@ -0,0 +1,427 @@
+#ifndef BIGINT_WIDE_INT_H
+#define BIGINT_WIDE_INT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "big_integer.h"
+#include "limb_kernels.h"
+
+// Integer of a fixed number of bits stored inline, for values with a known
+// bound such as 256-bit keys and hashes. Arithmetic wraps modulo 2^Bits
+// like the built-in unsigned types; the signed flavour is two's complement
+// and wraps the same way. Shifting by Bits or more gives 0, or -1 when a
+// negative value is shifted right. Everything but the big_integer
+// conversions is constexpr and runs the limb kernels with a constant
+// length, which the compiler unrolls. Being a literal type, it can hold
+// constant tables that are computed at compile time and live in rodata.
+template<size_t Bits, bool Signed>
+class wide_integer {
+	static_assert(Bits > 0 && Bits % 32 == 0, "wide_integer holds whole 32-bit limbs");
+
+public:
+	static constexpr size_t LIMBS = Bits / 32;
+
+	constexpr wide_integer() : limbs_() {}
+
+	// Sign-extends signed values, as the built-in conversions do.
+	template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+	constexpr wide_integer(T value) : limbs_() {
+		uint64_t low = static_cast<uint64_t>(value);
+		uint32_t fill = std::is_signed<T>::value && value < 0 ? UINT32_MAX : 0;
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] = i < 2 ? static_cast<uint32_t>(low >> (32 * i)) : fill;
+		}
+	}
+
+	template<size_t OtherBits, bool OtherSigned>
+	explicit constexpr wide_integer(wide_integer<OtherBits, OtherSigned> const& other) : limbs_() {
+		uint32_t fill = other.negative() ? UINT32_MAX : 0;
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] = i < other.LIMBS ? other.limbs()[i] : fill;
+		}
+	}
+
+	// Keeps the low Bits bits of the two's complement of value.
+	explicit wide_integer(big_integer const& value) : limbs_() {
+		size_t n = std::min(value.digits_.size(), LIMBS);
+		for (size_t i = 0; i < n; i++) {
+			limbs_[i] = value.digits_[i];
+		}
+		if (value.sign_) {
+			*this = -*this;
+		}
+	}
+
+	operator big_integer() const {
+		wide_integer magnitude = negative() ? -*this : *this;
+		big_integer result;
+		result.assign_digits(magnitude.limbs_, LIMBS, negative());
+		return result;
+	}
+
+	constexpr uint32_t const* limbs() const {
+		return limbs_;
+	}
+
+	constexpr bool negative() const {
+		return Signed && (limbs_[LIMBS - 1] >> 31u) != 0;
+	}
+
+	explicit constexpr operator bool() const {
+		return limbs::normalized_size(limbs_, LIMBS) != 0;
+	}
+
+	static constexpr wide_integer max() {
+		wide_integer result = ~wide_integer();
+		if (Signed) {
+			result.limbs_[LIMBS - 1] >>= 1u;
+		}
+		return result;
+	}
+
+	static constexpr wide_integer min() {
+		wide_integer result;
+		if (Signed) {
+			result.limbs_[LIMBS - 1] = 1u << 31u;
+		}
+		return result;
+	}
+
+	constexpr wide_integer& operator+=(wide_integer const& rhs) {
+		limbs::add_n(limbs_, limbs_, rhs.limbs_, LIMBS);
+		return *this;
+	}
+
+	constexpr wide_integer& operator-=(wide_integer const& rhs) {
+		limbs::sub_n(limbs_, limbs_, rhs.limbs_, LIMBS);
+		return *this;
+	}
+
+	// Only the low LIMBS limbs of the product are formed.
+	constexpr wide_integer& operator*=(wide_integer const& rhs) {
+		uint32_t product[LIMBS] = {};
+		for (size_t j = 0; j < LIMBS; j++) {
+			limbs::addmul_1(product + j, limbs_, LIMBS - j, rhs.limbs_[j]);
+		}
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] = product[i];
+		}
+		return *this;
+	}
+
+	constexpr wide_integer& operator/=(wide_integer const& rhs) {
+		div_mod(*this, rhs, this, nullptr);
+		return *this;
+	}
+
+	constexpr wide_integer& operator%=(wide_integer const& rhs) {
+		div_mod(*this, rhs, nullptr, this);
+		return *this;
+	}
+
+	constexpr wide_integer& operator&=(wide_integer const& rhs) {
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] &= rhs.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr wide_integer& operator|=(wide_integer const& rhs) {
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] |= rhs.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr wide_integer& operator^=(wide_integer const& rhs) {
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] ^= rhs.limbs_[i];
+		}
+		return *this;
+	}
+
+	constexpr wide_integer& operator<<=(int rhs) {
+		size_t whole = static_cast<size_t>(rhs) / 32;
+		uint32_t part = static_cast<uint32_t>(rhs) % 32;
+		for (size_t i = LIMBS; i > 0; i--) {
+			limbs_[i - 1] = i - 1 >= whole ? limbs_[i - 1 - whole] : 0;
+		}
+		if (part && whole < LIMBS) {
+			limbs::lshift(limbs_ + whole, limbs_ + whole, LIMBS - whole, part);
+		}
+		return *this;
+	}
+
+	// Arithmetic for the signed flavour, logical for the unsigned one.
+	constexpr wide_integer& operator>>=(int rhs) {
+		uint32_t fill = negative() ? UINT32_MAX : 0;
+		size_t whole = static_cast<size_t>(rhs) / 32;
+		uint32_t part = static_cast<uint32_t>(rhs) % 32;
+		for (size_t i = 0; i < LIMBS; i++) {
+			limbs_[i] = i + whole < LIMBS ? limbs_[i + whole] : fill;
+		}
+		if (part && whole < LIMBS) {
+			limbs::rshift(limbs_, limbs_, LIMBS - whole, part);
+			limbs_[LIMBS - whole - 1] |= fill << (32 - part);
+		}
+		return *this;
+	}
+
+	constexpr wide_integer operator+() const {
+		return *this;
+	}
+
+	constexpr wide_integer operator-() const {
+		wide_integer result = ~*this;
+		limbs::add_1(result.limbs_, result.limbs_, LIMBS, 1);
+		return result;
+	}
+
+	constexpr wide_integer operator~() const {
+		wide_integer result;
+		for (size_t i = 0; i < LIMBS; i++) {
+			result.limbs_[i] = ~limbs_[i];
+		}
+		return result;
+	}
+
+	constexpr wide_integer& operator++() {
+		limbs::add_1(limbs_, limbs_, LIMBS, 1);
+		return *this;
+	}
+
+	constexpr wide_integer& operator--() {
+		limbs::sub_1(limbs_, limbs_, LIMBS, 1);
+		return *this;
+	}
+
+	constexpr wide_integer operator++(int) {
+		wide_integer old = *this;
+		++*this;
+		return old;
+	}
+
+	constexpr wide_integer operator--(int) {
+		wide_integer old = *this;
+		--*this;
+		return old;
+	}
+
+	friend constexpr wide_integer operator+(wide_integer a, wide_integer const& b) {
+		return a += b;
+	}
+
+	friend constexpr wide_integer operator-(wide_integer a, wide_integer const& b) {
+		return a -= b;
+	}
+
+	friend constexpr wide_integer operator*(wide_integer a, wide_integer const& b) {
+		return a *= b;
+	}
+
+	friend constexpr wide_integer operator/(wide_integer a, wide_integer const& b) {
+		return a /= b;
+	}
+
+	friend constexpr wide_integer operator%(wide_integer a, wide_integer const& b) {
+		return a %= b;
+	}
+
+	friend constexpr wide_integer operator&(wide_integer a, wide_integer const& b) {
+		return a &= b;
+	}
+
+	friend constexpr wide_integer operator|(wide_integer a, wide_integer const& b) {
+		return a |= b;
+	}
+
+	friend constexpr wide_integer operator^(wide_integer a, wide_integer const& b) {
+		return a ^= b;
+	}
+
+	friend constexpr wide_integer operator<<(wide_integer a, int b) {
+		return a <<= b;
+	}
+
+	friend constexpr wide_integer operator>>(wide_integer a, int b) {
+		return a >>= b;
+	}
+
+	friend constexpr bool operator==(wide_integer const& a, wide_integer const& b) {
+		return limbs::cmp_n(a.limbs_, b.limbs_, LIMBS) == 0;
+	}
+
+	friend constexpr bool operator!=(wide_integer const& a, wide_integer const& b) {
+		return !(a == b);
+	}
+
+	friend constexpr bool operator<(wide_integer const& a, wide_integer const& b) {
+		if (a.negative() != b.negative()) {
+			return a.negative();
+		}
+		return limbs::cmp_n(a.limbs_, b.limbs_, LIMBS) < 0;
+	}
+
+	friend constexpr bool operator>(wide_integer const& a, wide_integer const& b) {
+		return b < a;
+	}
+
+	friend constexpr bool operator<=(wide_integer const& a, wide_integer const& b) {
+		return !(b < a);
+	}
+
+	friend constexpr bool operator>=(wide_integer const& a, wide_integer const& b) {
+		return !(a < b);
+	}
+
+	friend constexpr wide_integer pow(wide_integer base, unsigned exponent) {
+		wide_integer result = 1;
+		for (; exponent != 0; exponent >>= 1u) {
+			if (exponent & 1u) {
+				result *= base;
+			}
+			base *= base;
+		}
+		return result;
+	}
+
+	friend std::string to_string(wide_integer const& a, int base = 10) {
+		return to_string(static_cast<big_integer>(a), base);
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, wide_integer const& a) {
+		return s << static_cast<big_integer>(a);
+	}
+
+private:
+	uint32_t limbs_[LIMBS];
+
+	// Truncating division like the built-in types: the quotient rounds
+	// toward zero and the remainder takes the sign of the dividend.
+	static constexpr void div_mod(wide_integer const& a, wide_integer const& b,
+	                              wide_integer* quotient, wide_integer* remainder) {
+		bool a_negative = a.negative();
+		bool b_negative = b.negative();
+		wide_integer u = a_negative ? -a : a;
+		wide_integer v = b_negative ? -b : b;
+		size_t un = limbs::normalized_size(u.limbs_, LIMBS);
+		size_t vn = limbs::normalized_size(v.limbs_, LIMBS);
+		if (vn == 0) {
+			throw std::runtime_error("Division by zero");
+		}
+		wide_integer q, r;
+		if (un < vn) {
+			r = u;
+		} else if (vn == 1) {
+			r.limbs_[0] = limbs::divrem_1(q.limbs_, u.limbs_, un, v.limbs_[0]);
+		} else {
+			uint32_t shift = limbs::clz(v.limbs_[vn - 1]);
+			uint32_t nv[LIMBS] = {};
+			uint32_t nu[LIMBS + 1] = {};
+			for (size_t i = 0; i < un; i++) {
+				nu[i] = u.limbs_[i];
+			}
+			for (size_t i = 0; i < vn; i++) {
+				nv[i] = v.limbs_[i];
+			}
+			if (shift) {
+				limbs::lshift(nv, nv, vn, shift);
+				nu[un] = limbs::lshift(nu, nu, un, shift);
+				limbs::divrem_normalized(q.limbs_, nu, un, nv, vn);
+				limbs::rshift(r.limbs_, nu, vn, shift);
+			} else {
+				limbs::divrem_normalized(q.limbs_, nu, un, nv, vn);
+				for (size_t i = 0; i < vn; i++) {
+					r.limbs_[i] = nu[i];
+				}
+			}
+		}
+		if (quotient) {
+			*quotient = a_negative != b_negative ? -q : q;
+		}
+		if (remainder) {
+			*remainder = a_negative ? -r : r;
+		}
+	}
+};
+
+template<size_t Bits>
+using wide_uint = wide_integer<Bits, false>;
+
+template<size_t Bits>
+using wide_int = wide_integer<Bits, true>;
+
+// {1, base, base^2, ..., base^(N - 1)}; assign it to a constexpr variable
+// to get the table at compile time.
+template<size_t N, size_t Bits, bool Signed>
+constexpr std::array<wide_integer<Bits, Signed>, N> power_table(wide_integer<Bits, Signed> base) {
+	std::array<wide_integer<Bits, Signed>, N> table{};
+	wide_integer<Bits, Signed> power = 1;
+	for (size_t i = 0; i < N; i++) {
+		table[i] = power;
+		power *= base;
+	}
+	return table;
+}
+
+namespace wide_literal {
+constexpr uint32_t base(char const* text, size_t n) {
+	if (n > 1 && text[0] == '0') {
+		return text[1] == 'x' || text[1] == 'X' ? 16 : text[1] == 'b' || text[1] == 'B' ? 2 : 8;
+	}
+	return 10;
+}
+
+constexpr size_t prefix(char const* text, size_t n) {
+	uint32_t b = base(text, n);
+	return b == 16 || b == 2 ? 2 : 0;
+}
+
+constexpr uint32_t digit(char c) {
+	return c >= 'a' ? c - 'a' + 10 : c >= 'A' ? c - 'A' + 10 : c - '0';
+}
+
+// Enough whole limbs for the digits and a sign bit; log2(10) < 3.322.
+constexpr size_t bits(char const* text, size_t n) {
+	size_t digits = 0;
+	for (size_t i = prefix(text, n); i < n; i++) {
+		digits += text[i] != '\'';
+	}
+	uint32_t b = base(text, n);
+	size_t value_bits = b == 10 ? (digits * 3322 + 999) / 1000 : digits * (b == 16 ? 4 : b == 8 ? 3 : 1);
+	return (value_bits + 1 + 31) / 32 * 32;
+}
+
+template<size_t Bits>
+constexpr wide_int<Bits> value(char const* text, size_t n) {
+	uint32_t b = base(text, n);
+	wide_int<Bits> result;
+	for (size_t i = prefix(text, n); i < n; i++) {
+		if (text[i] != '\'') {
+			result = result * b + digit(text[i]);
+		}
+	}
+	return result;
+}
+
+template<char... Chars>
+struct literal {
+	static constexpr char text[] = {Chars...};
+	static constexpr size_t length = sizeof...(Chars);
+};
+}
+
+// Integer literal of any length, evaluated at compile time into the
+// narrowest wide_int that holds it with a sign bit, so that -12_bi is
+// negative. Decimal, 0x, 0b and octal forms and digit separators work.
+// The result converts implicitly to big_integer.
+template<char... Chars>
+constexpr auto operator""_bi() {
+	using text = wide_literal::literal<Chars...>;
+	return wide_literal::value<wide_literal::bits(text::text, text::length)>(text::text, text::length);
+}
+#endif //BIGINT_WIDE_INT_H
@@ -1,5 +1,7 @@
 #include "big_integer.h"
 
+#include <stdexcept>
+
 using uint128_t = unsigned __int128;
 
 #define _POSITIVE (false)
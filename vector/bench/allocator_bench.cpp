@@ -0,0 +1,50 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "vector.h"
+#include "monotonic_allocator.h"
+
+// Builds short-lived vectors of strings the way a request handler would,
+// once with the default heap and once from a monotonic buffer that is
+// reset after every round.
+
+namespace {
+size_t const rounds = 20000;
+size_t const vectors_per_round = 16;
+size_t const elements = 64;
+
+template<typename Vector, typename MakeVector, typename Reset>
+double run(MakeVector make_vector, Reset reset) {
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round != rounds; ++round) {
+        for (size_t v = 0; v != vectors_per_round; ++v) {
+            Vector values = make_vector();
+            for (size_t i = 0; i != elements; ++i)
+                values.push_back(i * round);
+            checksum += values.back();
+        }
+        reset();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    if (checksum == 1)
+        std::printf("%zu\n", checksum);
+    return std::chrono::duration<double, std::nano>(finish - start).count() / rounds;
+}
+}
+
+int main() {
+    double heap = run<vector<size_t> >([] { return vector<size_t>(); }, [] {});
+
+    static char buffer[1 << 20];
+    monotonic_buffer pool(buffer, sizeof buffer);
+    typedef vector<size_t, monotonic_allocator<size_t> > pooled_vector;
+    double monotonic = run<pooled_vector>([&] { return pooled_vector(monotonic_allocator<size_t>(pool)); },
+                                          [&] { pool.reset(); });
+
+    std::printf("%-20s %14s\n", "allocator", "ns/round");
+    std::printf("%-20s %14.1f\n", "std::allocator", heap);
+    std::printf("%-20s %14.1f\n", "monotonic_allocator", monotonic);
+    return 0;
+}
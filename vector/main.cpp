@@ -1,4 +1,5 @@
 #include "vector.h"
+#include "monotonic_allocator.h"
 #include "gtest/gtest.h"
 #include <unordered_set>
 
@@ -522,3 +523,25 @@ TEST(correctness, ctor_alloc) {
   EXPECT_EQ(1, b.capacity());
 }
 
+
+TEST(correctness, monotonic_allocator) {
+  alignas(std::max_align_t) char buffer[1 << 12];
+  monotonic_buffer pool(buffer, sizeof buffer);
+  {
+    vector<element<size_t>, monotonic_allocator<element<size_t> > > a{monotonic_allocator<element<size_t> >(pool)};
+    for (size_t i = 0; i != 50; ++i)
+      a.push_back(i);
+
+    auto b = a;
+    b.push_back(50);
+    EXPECT_EQ(50, b[50]);
+
+    char const* first = reinterpret_cast<char const*>(a.data());
+    EXPECT_TRUE(first >= buffer && first < buffer + sizeof buffer);
+    EXPECT_TRUE(b.get_allocator() == a.get_allocator());
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<int, monotonic_allocator<int> > small{monotonic_allocator<int>(pool)};
+  EXPECT_THROW(small.reserve(sizeof buffer), std::bad_alloc);
+}
@@ -0,0 +1,73 @@
+#ifndef MONOTONIC_ALLOCATOR_H
+#define MONOTONIC_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Hands out memory from a caller-owned buffer by bumping a pointer.
+// Deallocation is a no-op; reset() makes the whole buffer available again.
+class monotonic_buffer {
+public:
+    monotonic_buffer(void* buffer, size_t size) :
+    begin_(static_cast<char*>(buffer)), current_(begin_), end_(begin_ + size) {}
+
+    monotonic_buffer(monotonic_buffer const&) = delete;
+    monotonic_buffer& operator=(monotonic_buffer const&) = delete;
+
+    void* allocate(size_t size, size_t alignment) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(current_);
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (size + padding > static_cast<size_t>(end_ - current_))
+            throw std::bad_alloc();
+        char* result = current_ + padding;
+        current_ = result + size;
+        return result;
+    }
+
+    void reset() {
+        current_ = begin_;
+    }
+
+    size_t used() const {
+        return current_ - begin_;
+    }
+
+private:
+    char* begin_;
+    char* current_;
+    char* end_;
+};
+
+template<typename T>
+struct monotonic_allocator {
+    typedef T value_type;
+
+    explicit monotonic_allocator(monotonic_buffer& buffer) : buffer_(&buffer) {}
+
+    template<typename U>
+    monotonic_allocator(monotonic_allocator<U> const& other) : buffer_(other.buffer_) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(buffer_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template<typename U>
+    friend struct monotonic_allocator;
+
+    template<typename U>
+    bool operator==(monotonic_allocator<U> const& other) const {
+        return buffer_ == other.buffer_;
+    }
+
+    template<typename U>
+    bool operator!=(monotonic_allocator<U> const& other) const {
+        return buffer_ != other.buffer_;
+    }
+
+private:
+    monotonic_buffer* buffer_;
+};
+#endif
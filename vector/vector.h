@@ -2,13 +2,19 @@
 #define VECTOR_H
 
 #include <algorithm>
-template <typename T>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+template <typename T, typename Allocator = std::allocator<T> >
 struct vector
 {
     typedef T* iterator;
     typedef T const* const_iterator;
+    typedef Allocator allocator_type;
 
     vector();                               // O(1) nothrow
+    explicit vector(Allocator const&);      // O(1) nothrow
     vector(vector const&);                  // O(N) strong
     vector& operator=(vector const& other); // O(N) strong
 
@@ -54,208 +60,248 @@ struct vector
     iterator erase(iterator first, iterator last); // O(N) weak
     iterator erase(const_iterator first, const_iterator last); // O(N) weak
 
+    allocator_type get_allocator() const;   // O(1) nothrow
+
 private:
-	vector(T const*, size_t size, size_t capacity);
+    typedef std::allocator_traits<Allocator> alloc_traits;
+
+	vector(T const*, size_t size, size_t capacity, Allocator const& alloc);
+	void swap_buffers(vector&);
+	static void swap_allocators(Allocator&, Allocator&, std::true_type);
+	static void swap_allocators(Allocator&, Allocator&, std::false_type);
 private:
+    Allocator alloc_;
     T* data_;
     size_t size_;
     size_t capacity_;
 };
 
-template<typename T> 
-vector<T>::vector() :
+template<typename T, typename Allocator>
+vector<T, Allocator>::vector() :
 data_(nullptr), size_(0), capacity_(0) {}
 
-template<typename T>
-vector<T>::vector(T const* data, size_t size, size_t capacity) {
+template<typename T, typename Allocator>
+vector<T, Allocator>::vector(Allocator const& alloc) :
+alloc_(alloc), data_(nullptr), size_(0), capacity_(0) {}
+
+template<typename T, typename Allocator>
+vector<T, Allocator>::vector(T const* data, size_t size, size_t capacity, Allocator const& alloc) :
+alloc_(alloc) {
     capacity_ = capacity;
-	data_ = capacity ? static_cast<T*>(operator new(capacity * sizeof(T))) : nullptr;
+	data_ = capacity ? alloc_traits::allocate(alloc_, capacity) : nullptr;
 	try {
         for (size_ = 0; size_ < size; size_++)
-            new(end()) T(data[size_]);
+            alloc_traits::construct(alloc_, end(), data[size_]);
     } catch (...) {
 	    clear();
-	    operator delete(data_);
+	    if (data_)
+	        alloc_traits::deallocate(alloc_, data_, capacity_);
 	    throw;
 	}
 }
 
-template<typename T>
-vector<T>::vector(vector const& other) :
-vector(other.data_, other.size_, other.size_) {}
+template<typename T, typename Allocator>
+vector<T, Allocator>::vector(vector const& other) :
+vector(other.data_, other.size_, other.size_,
+       alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
 
-template<typename T>
-vector<T>::~vector() {
+template<typename T, typename Allocator>
+vector<T, Allocator>::~vector() {
     clear();
-    operator delete(data_);
+    if (data_)
+        alloc_traits::deallocate(alloc_, data_, capacity_);
 }
 
-template<typename T>
-vector<T>& vector<T>::operator=(vector const& other) {
-    vector<T> new_vector(other);
-    swap(new_vector);
+template<typename T, typename Allocator>
+vector<T, Allocator>& vector<T, Allocator>::operator=(vector const& other) {
+    vector new_vector(other.data_, other.size_, other.size_,
+                      alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+    swap_allocators(new_vector.alloc_, alloc_,
+                    typename alloc_traits::propagate_on_container_copy_assignment());
+    swap_buffers(new_vector);
     return *this;
 }
 
-template<typename T>
-T& vector<T>::operator[](size_t i) {
+template<typename T, typename Allocator>
+T& vector<T, Allocator>::operator[](size_t i) {
 	return data_[i];
 }
 
-template<typename T>
-T const& vector<T>::operator[](size_t i) const {
+template<typename T, typename Allocator>
+T const& vector<T, Allocator>::operator[](size_t i) const {
 	return data_[i];
 }
 
-template<typename T>
-T* vector<T>::data() {
+template<typename T, typename Allocator>
+T* vector<T, Allocator>::data() {
     return data_;
 }
 
-template<typename T>
-T const* vector<T>::data() const {
+template<typename T, typename Allocator>
+T const* vector<T, Allocator>::data() const {
     return data_;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::begin() {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::begin() {
     return data_;
 }
 
-template<typename T>
-typename vector<T>::const_iterator vector<T>::begin() const {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::begin() const {
     return data_;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::end() {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::end() {
     return (data_ + size_);
 }
 
-template<typename T>
-typename vector<T>::const_iterator vector<T>::end() const {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::end() const {
     return (data_ + size_);
 }
 
-template<typename T>
-T& vector<T>::front() {
+template<typename T, typename Allocator>
+T& vector<T, Allocator>::front() {
     return *begin();
 }
 
-template<typename T>
-T const& vector<T>::front() const {
+template<typename T, typename Allocator>
+T const& vector<T, Allocator>::front() const {
     return *begin();
 }
 
-template<typename T>
-T& vector<T>::back() {
+template<typename T, typename Allocator>
+T& vector<T, Allocator>::back() {
     return *(end() - 1);
 }
 
-template<typename T>
-T const& vector<T>::back() const {
+template<typename T, typename Allocator>
+T const& vector<T, Allocator>::back() const {
     return *(end() - 1);
 }
 
 
-template<typename T>
-void vector<T>::swap(vector& other) {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::swap(vector& other) {
+    swap_allocators(other.alloc_, alloc_,
+                    typename alloc_traits::propagate_on_container_swap());
+    swap_buffers(other);
+}
+
+template<typename T, typename Allocator>
+void vector<T, Allocator>::swap_buffers(vector& other) {
 	using std::swap;
     swap(other.data_, data_);
     swap(other.size_, size_);
     swap(other.capacity_, capacity_);
 }
 
-template<typename T>
-size_t vector<T>::size() const {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::swap_allocators(Allocator& a, Allocator& b, std::true_type) {
+	using std::swap;
+	swap(a, b);
+}
+
+template<typename T, typename Allocator>
+void vector<T, Allocator>::swap_allocators(Allocator&, Allocator&, std::false_type) {}
+
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::allocator_type vector<T, Allocator>::get_allocator() const {
+    return alloc_;
+}
+
+template<typename T, typename Allocator>
+size_t vector<T, Allocator>::size() const {
     return size_;
 }
 
-template<typename T>
-size_t vector<T>::capacity() const {
+template<typename T, typename Allocator>
+size_t vector<T, Allocator>::capacity() const {
     return capacity_;
 }
 
-template<typename T>
-void vector<T>::pop_back() {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::pop_back() {
 	size_--;
-	data_[size_].~T();
+	alloc_traits::destroy(alloc_, data_ + size_);
 }
 
-template<typename T>
-void vector<T>::clear() {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::clear() {
     while (size_)
         pop_back();
 }
 
-template<typename T>
-bool vector<T>::empty() const {
+template<typename T, typename Allocator>
+bool vector<T, Allocator>::empty() const {
     return (size_ == 0);
 }
 
-template<typename T>
-void vector<T>::shrink_to_fit() {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::shrink_to_fit() {
     if (capacity_ == size_)
         return;
-    vector<T> new_vector(data_, size_, size_);
-    swap(new_vector);
+    vector new_vector(data_, size_, size_, alloc_);
+    swap_buffers(new_vector);
 }
 
-template<typename T>
-void vector<T>::push_back(T const& el) {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::push_back(T const& el) {
 	if (size_ == capacity_) {
 		T copy_el = T(el);
 		reserve(capacity_ * 2 + 1);
-		new (end()) T(copy_el);
+		alloc_traits::construct(alloc_, end(), copy_el);
 	} else {
-		new (end()) T(el);
+		alloc_traits::construct(alloc_, end(), el);
 	}
 	size_++;
 }
 
-template<typename T>
-void vector<T>::reserve(size_t new_capacity) {
+template<typename T, typename Allocator>
+void vector<T, Allocator>::reserve(size_t new_capacity) {
     if (capacity_ >= new_capacity)
         return;
-    vector<T> new_vector(data_, size_, new_capacity);
-    swap(new_vector);
+    vector new_vector(data_, size_, new_capacity, alloc_);
+    swap_buffers(new_vector);
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::insert(iterator pos, T const& el) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(iterator pos, T const& el) {
 	using std::swap;
-	ptrdiff_t ind = pos - data_;
+	std::ptrdiff_t ind = pos - data_;
 	push_back(el);
 	for (size_t i = size_ - 1; i > ind; i--)
 		swap(data_[i], data_[i - 1]);
 	return begin() + ind;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos, T const& el) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos, T const& el) {
 	using std::swap;
-	ptrdiff_t ind = pos - data_;
+	std::ptrdiff_t ind = pos - data_;
 	push_back(el);
 	for (size_t i = size_ - 1; i > ind; i--)
 		swap(data_[i], data_[i - 1]);
 	return begin() + ind;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(iterator pos) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(iterator pos) {
 	return erase(pos, pos + 1);
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(const_iterator pos) {
 	return erase(pos, pos + 1);
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(iterator first, iterator last) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(iterator first, iterator last) {
 	using std::swap;
-	ptrdiff_t ind = first - data_;
-	ptrdiff_t len = last - first;
+	std::ptrdiff_t ind = first - data_;
+	std::ptrdiff_t len = last - first;
 	for (; ind != size_ - len; ind++)
 		swap(data_[ind], data_[ind + len]);
 	while (len--) {
@@ -264,11 +310,11 @@ typename vector<T>::iterator vector<T>::erase(iterator first, iterator last) {
 	return begin() + ind;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator last) {
+template<typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(const_iterator first, const_iterator last) {
 	using std::swap;
-	ptrdiff_t ind = first - data_;
-	ptrdiff_t len = last - first;
+	std::ptrdiff_t ind = first - data_;
+	std::ptrdiff_t len = last - first;
 	for (; ind != size_ - len; ind++)
 		swap(data_[ind], data_[ind + len]);
 	while (len--) {